@@ -0,0 +1,79 @@
+/**
+  @file ArbinAtomico.cpp
+
+  Coste de los contadores de referencias atmicos de Arbin
+  (Arbin<T, true>) frente a los normales. En cada ronda se
+  construye un rbol equilibrado, se suman sus elementos
+  recorrindolo con hijoIz e hijoDr (que copian subrboles
+  y tocan los contadores) y se copia; todo ello, con cada
+  uno de los dos tipos de contador.
+
+  Compilacin (desde esta carpeta):
+
+    g++ -O2 -std=c++11 -pthread ArbinAtomico.cpp -o ArbinAtomico
+
+  Uso: ArbinAtomico [nodos [rondas]]
+  (por defecto 1048576 nodos y 5 rondas).
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+
+#include "../TADs/Arborescentes/Arbin.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+typedef std::chrono::steady_clock Reloj;
+
+/** Segundos transcurridos desde ini. */
+static double segundos(Reloj::time_point ini) {
+	return std::chrono::duration<double>(Reloj::now() - ini).count();
+}
+
+/** rbol equilibrado con los enteros de [ini, fin). */
+template <class A>
+static A construye(int ini, int fin) {
+	if (ini >= fin)
+		return A();
+	int mitad = ini + (fin - ini) / 2;
+	return A(construye<A>(ini, mitad), mitad, construye<A>(mitad + 1, fin));
+}
+
+/** Suma de los elementos, bajando con hijoIz e hijoDr. */
+template <class A>
+static long long suma(const A &a) {
+	if (a.esVacio())
+		return 0;
+	return a.raiz() + suma(a.hijoIz()) + suma(a.hijoDr());
+}
+
+/** Tiempo de las rondas de construccin, suma y copia. */
+template <class A>
+static double mide(int n, int rondas, long long &total) {
+	Reloj::time_point ini = Reloj::now();
+	for (int r = 0; r < rondas; ++r) {
+		A a = construye<A>(0, n);
+		total += suma(a);
+		A copia(a);
+		total += copia.numNodos();
+	}
+	return segundos(ini);
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+	int rondas = argc > 2 ? std::atoi(argv[2]) : 5;
+
+	long long total = 0;
+	double tNormal = mide<Arbin<int, false> >(n, rondas, total);
+	double tAtomico = mide<Arbin<int, true> >(n, rondas, total);
+
+	std::cout << n << " nodos, " << rondas << " rondas\n"
+	          << "Arbin<int>:       " << tNormal << " s\n"
+	          << "Arbin<int, true>: " << tAtomico << " s\n"
+	          << "(suma de control " << total << ")\n";
+	return 0;
+}
@@ -0,0 +1,111 @@
+/**
+  @file Arbus.cpp
+
+  Medida de las operaciones bsicas de Arbus (inserta,
+  consulta, borra, copia y destruccin) con un milln de
+  claves enteras insertadas en orden aleatorio, y prueba
+  de copia y destruccin de un rbol degenerado (una
+  lista de varios millones de nodos) que con las versiones
+  recursivas desbordaba la pila.
+
+  Compilacin (desde esta carpeta):
+
+    g++ -O2 -std=c++11 Arbus.cpp -o Arbus
+
+  Uso: Arbus [claves [repeticiones [degenerado]]]
+  (por defecto 1000000 claves, 3 repeticiones, de las que
+  se da la media, y un rbol degenerado de 5000000 nodos;
+  0 para no construirlo). Las claves se barajan con
+  semilla fija.
+
+  Para comparar con otra versin de Arbus.h basta con
+  compilar este mismo programa con ella.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+
+#include "../TADs/Arborescentes/Arbus.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock Reloj;
+
+/** Segundos transcurridos desde ini. */
+static double segundos(Reloj::time_point ini) {
+	return std::chrono::duration<double>(Reloj::now() - ini).count();
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	int repeticiones = argc > 2 ? std::atoi(argv[2]) : 3;
+	int degenerado = argc > 3 ? std::atoi(argv[3]) : 5000000;
+
+	std::vector<int> claves(n);
+	for (int i = 0; i < n; ++i)
+		claves[i] = i;
+	std::mt19937 azar(2012);
+	std::shuffle(claves.begin(), claves.end(), azar);
+
+	double tInserta = 0, tConsulta = 0, tCopia = 0, tLibera = 0, tBorra = 0;
+	long long suma = 0;
+	for (int r = 0; r < repeticiones; ++r) {
+		Arbus<int, int> *arbol = new Arbus<int, int>();
+
+		Reloj::time_point ini = Reloj::now();
+		for (int i = 0; i < n; ++i)
+			arbol->inserta(claves[i], i);
+		tInserta += segundos(ini);
+
+		ini = Reloj::now();
+		for (int i = 0; i < n; ++i)
+			suma += arbol->consulta(claves[i]);
+		tConsulta += segundos(ini);
+
+		ini = Reloj::now();
+		Arbus<int, int> *copia = new Arbus<int, int>(*arbol);
+		tCopia += segundos(ini);
+
+		ini = Reloj::now();
+		delete copia;
+		tLibera += segundos(ini);
+
+		ini = Reloj::now();
+		for (int i = 0; i < n; ++i)
+			arbol->borra(claves[i]);
+		tBorra += segundos(ini);
+
+		delete arbol;
+	}
+
+	std::cout << n << " claves al azar, media de " << repeticiones
+	          << " repeticiones\n"
+	          << "inserta:  " << tInserta / repeticiones << " s\n"
+	          << "consulta: " << tConsulta / repeticiones << " s\n"
+	          << "borra:    " << tBorra / repeticiones << " s\n"
+	          << "copia:    " << tCopia / repeticiones << " s\n"
+	          << "libera:   " << tLibera / repeticiones << " s\n"
+	          << "(suma de control " << suma << ")\n";
+
+	if (degenerado > 0) {
+		// Claves crecientes: cada una, hija derecha de la
+		// anterior
+		Reloj::time_point ini = Reloj::now();
+		{
+			Arbus<int, int> lista;
+			for (int i = 0; i < degenerado; ++i)
+				lista.inserta(i, i);
+			Arbus<int, int> copia(lista);
+		}
+		std::cout << "degenerado de " << degenerado
+		          << " nodos construido, copiado y liberado en "
+		          << segundos(ini) << " s\n";
+	}
+	return 0;
+}
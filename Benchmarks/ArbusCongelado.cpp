@@ -0,0 +1,80 @@
+/**
+  @file ArbusCongelado.cpp
+
+  Medida de las consultas en un ArbusCongelado (claves en
+  disposicin de Eytzinger) frente al Arbus del que se
+  obtiene con congela(). El Arbus se construye con
+  desdeOrdenado, as que est perfectamente equilibrado y
+  sus nodos estn contiguos en inorden: la diferencia se
+  debe slo a la disposicin de las claves en memoria.
+
+  Compilacin (desde esta carpeta):
+
+    g++ -O2 -std=c++11 ArbusCongelado.cpp -o ArbusCongelado
+
+  Uso: ArbusCongelado [claves [consultas]]
+  (por defecto 16777216 claves y 4000000 consultas de
+  claves presentes, elegidas al azar con semilla fija).
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+
+#include "../TADs/Arborescentes/Arbus.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+typedef std::chrono::steady_clock Reloj;
+
+/** Segundos transcurridos desde ini. */
+static double segundos(Reloj::time_point ini) {
+	return std::chrono::duration<double>(Reloj::now() - ini).count();
+}
+
+/**
+ Consulta todas las claves de consultas en d y devuelve
+ el tiempo empleado; la suma de los valores se acumula
+ en suma para que el compilador no elimine el bucle.
+ */
+template <class D>
+static double mide(const D &d, const std::vector<int> &consultas, long long &suma) {
+	Reloj::time_point ini = Reloj::now();
+	for (std::size_t i = 0; i < consultas.size(); ++i)
+		suma += d.consulta(consultas[i]);
+	return segundos(ini);
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1 << 24;
+	int q = argc > 2 ? std::atoi(argv[2]) : 4000000;
+
+	// Claves pares, para que las impares no estn
+	std::vector<std::pair<int, int> > parejas(n);
+	for (int i = 0; i < n; ++i)
+		parejas[i] = std::make_pair(2 * i, i);
+	Arbus<int, int> arbol =
+		Arbus<int, int>::desdeOrdenado(parejas.begin(), parejas.end());
+	ArbusCongelado<int, int> congelado = arbol.congela();
+
+	std::mt19937 azar(2012);
+	std::uniform_int_distribution<int> posicion(0, n - 1);
+	std::vector<int> consultas(q);
+	for (int i = 0; i < q; ++i)
+		consultas[i] = 2 * posicion(azar);
+
+	long long suma = 0;
+	double tArbus = mide(arbol, consultas, suma);
+	double tCongelado = mide(congelado, consultas, suma);
+
+	std::cout << n << " claves, " << q << " consultas al azar\n"
+	          << "Arbus:           " << tArbus << " s\n"
+	          << "ArbusCongelado:  " << tCongelado << " s\n"
+	          << "(suma de control " << suma << ")\n";
+	return 0;
+}
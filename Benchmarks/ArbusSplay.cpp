@@ -0,0 +1,103 @@
+/**
+  @file ArbusSplay.cpp
+
+  Medida de ArbusSplay frente a ArbusAVL con accesos
+  sesgados: consultas que siguen una distribucin de Zipf
+  sobre un milln de claves enteras, de modo que unas pocas
+  claves se consultan muchsimo ms que el resto.
+
+  Compilacin (desde esta carpeta):
+
+    g++ -O2 -std=c++11 ArbusSplay.cpp -o ArbusSplay
+
+  Uso: ArbusSplay [claves [consultas [exponente]]]
+  (por defecto 1000000 claves, 5000000 consultas y
+  exponente 1.1). Las claves y las consultas se generan
+  con una semilla fija, as que dos ejecuciones miden
+  exactamente lo mismo.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+
+#include "../TADs/Arborescentes/ArbusSplay.h"
+#include "../TADs/Arborescentes/ArbusAVL.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock Reloj;
+
+/** Segundos transcurridos desde ini. */
+static double segundos(Reloj::time_point ini) {
+	return std::chrono::duration<double>(Reloj::now() - ini).count();
+}
+
+/**
+ Consulta todas las claves de consultas en a y devuelve
+ el tiempo empleado; la suma de los valores se acumula
+ en suma para que el compilador no elimine el bucle.
+ */
+template <class A>
+static double mide(A &a, const std::vector<int> &consultas, long long &suma) {
+	Reloj::time_point ini = Reloj::now();
+	for (std::size_t i = 0; i < consultas.size(); ++i)
+		suma += a.consulta(consultas[i]);
+	return segundos(ini);
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	int q = argc > 2 ? std::atoi(argv[2]) : 5000000;
+	double s = argc > 3 ? std::atof(argv[3]) : 1.1;
+
+	std::mt19937 azar(2012);
+
+	// Distribucin acumulada de Zipf sobre los rangos 1..n
+	std::vector<double> acumulada(n);
+	double total = 0;
+	for (int i = 0; i < n; ++i) {
+		total += 1.0 / std::pow(i + 1.0, s);
+		acumulada[i] = total;
+	}
+
+	// Las claves ms consultadas, repartidas al azar por
+	// todo el rango (si no, seran las ms pequeas)
+	std::vector<int> claves(n);
+	for (int i = 0; i < n; ++i)
+		claves[i] = 7 * i;
+	std::shuffle(claves.begin(), claves.end(), azar);
+
+	std::uniform_real_distribution<double> uniforme(0, total);
+	std::vector<int> consultas(q);
+	for (int i = 0; i < q; ++i) {
+		std::size_t rango = std::lower_bound(acumulada.begin(), acumulada.end(),
+		                                     uniforme(azar)) - acumulada.begin();
+		if (rango >= (std::size_t) n)
+			rango = n - 1;
+		consultas[i] = claves[rango];
+	}
+
+	ArbusSplay<int, int> splay;
+	ArbusAVL<int, int> avl;
+	for (int i = 0; i < n; ++i) {
+		splay.inserta(claves[i], i);
+		avl.inserta(claves[i], i);
+	}
+
+	long long suma = 0;
+	double tSplay = mide(splay, consultas, suma);
+	double tAVL = mide(avl, consultas, suma);
+
+	std::cout << n << " claves, " << q << " consultas Zipf(" << s << ")\n"
+	          << "ArbusSplay: " << tSplay << " s\n"
+	          << "ArbusAVL:   " << tAVL << " s\n"
+	          << "(suma de control " << suma << ")\n";
+	return 0;
+}
@@ -16,7 +16,204 @@
 
 #include "Lista.h" // Tipo devuelto por los recorridos
 
-#include "Cola.h" // Tipo auxiliar para implementar el recorrido por niveles
+#include "Pila.h" // Ascendientes pendientes en los iteradores
+
+#include "ColaCircular.h" // Nodos pendientes en el recorrido por niveles
+
+#include "Tabla.h" // Nodos ya construidos por Arbin::Fabrica
+
+#include "Arena.h" // Nodos de Arbin::FabricaEnArena
+
+#include <cstddef>
+#include <exception> // Excepciones de los hilos de reduce
+#include <new>
+#include <string>
+#include <thread> // Paralelismo fork-join en reduce
+#include <type_traits>
+#include <utility>
+
+#include <atomic> // Contadores de referencias compartidos entre hilos
+
+/**
+ Contador de referencias de los nodos de Arbin. La
+ versin normal (Atomico = false) es un entero; la
+ versin atmica permite que varios hilos compartan
+ (y liberen) la misma estructura de nodos.
+ */
+template <bool Atomico>
+class ContadorRefs {
+public:
+	ContadorRefs() : _n(0) {}
+
+	void incrementa() { assert(_n >= 0); _n++; }
+
+	/** Decrementa el contador; devuelve true si llega a 0. */
+	bool decrementa() { assert(_n > 0); return --_n == 0; }
+
+	/** Nmero de referencias. */
+	int valor() const { return _n; }
+
+private:
+	int _n;
+};
+
+/**
+ Versin atmica del contador. Incrementar no necesita
+ ordenar nada respecto a otros accesos (quien incrementa ya
+ tiene una referencia vlida), as que es relajado. El
+ decremento es de adquisicin y liberacin: liberacin para
+ que todo lo que el hilo hizo con el nodo ocurra antes de
+ que otro lo libere, y adquisicin para que el hilo que lo
+ deja a 0 vea todo eso antes de liberarlo.
+ */
+template <>
+class ContadorRefs<true> {
+public:
+	ContadorRefs() : _n(0) {}
+
+	void incrementa() {
+		_n.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool decrementa() {
+		return _n.fetch_sub(1, std::memory_order_acq_rel) == 1;
+	}
+
+	int valor() const {
+		return _n.load(std::memory_order_acquire);
+	}
+
+private:
+	std::atomic<int> _n;
+};
+
+/**
+ Medidas de un subrbol (nmero de nodos, talla y nmero de
+ hojas) que los nodos de Arbin pueden guardar. Como los nodos
+ no cambian tras crearse, se calculan una sola vez, en el
+ constructor, a partir de las de los hijos.
+
+ La versin normal (Cachea = false) no guarda nada: Arbin
+ calcula entonces las medidas recorriendo el rbol y nunca
+ llama a sus observadoras.
+ */
+template <bool Cachea>
+class MedidasArbin {
+public:
+	void calcula(const MedidasArbin *, const MedidasArbin *) {}
+
+	unsigned int numNodos() const { return 0; }
+	unsigned int talla() const { return 0; }
+	unsigned int numHojas() const { return 0; }
+};
+
+template <>
+class MedidasArbin<true> {
+public:
+	MedidasArbin() : _numNodos(1), _talla(1), _numHojas(1) {}
+
+	/**
+	 Calcula las medidas de un nodo dadas las de sus
+	 hijos (NULL si el hijo es vaco).
+	 */
+	void calcula(const MedidasArbin *iz, const MedidasArbin *dr) {
+		if ((iz == NULL) && (dr == NULL))
+			return; // Hoja; valen los valores iniciales
+		_numHojas = 0;
+		if (iz != NULL) {
+			_numNodos += iz->_numNodos;
+			_talla = 1 + iz->_talla;
+			_numHojas += iz->_numHojas;
+		}
+		if (dr != NULL) {
+			_numNodos += dr->_numNodos;
+			if (1 + dr->_talla > _talla)
+				_talla = 1 + dr->_talla;
+			_numHojas += dr->_numHojas;
+		}
+	}
+
+	unsigned int numNodos() const { return _numNodos; }
+	unsigned int talla() const { return _talla; }
+	unsigned int numHojas() const { return _numHojas; }
+
+private:
+	unsigned int _numNodos;
+	unsigned int _talla;
+	unsigned int _numHojas;
+};
+
+/**
+ Hash estructural ("de Merkle") de un subrbol, que los nodos
+ de Arbin pueden guardar: se calcula al crear el nodo a partir
+ del hash de su elemento (ver Hash.h) y de los hashes de sus
+ hijos, por lo que dos subrboles iguales tienen siempre el
+ mismo hash y dos distintos, casi con seguridad, no.
+
+ Para eso el hash del elemento tiene que ser bueno: el de
+ std::string de Hash.h (la suma de los caracteres) da el
+ mismo valor a cualquier par de anagramas, as que para
+ cadenas se usa FNV-1a sobre sus bytes. Con otros tipos se
+ usa su funcin hash, que debe distinguir bien los valores.
+
+ La versin normal (Calcula = false) no guarda nada y Arbin
+ no consulta su valor.
+ */
+template <bool Calcula>
+class HashArbin {
+public:
+	template <class T>
+	void calcula(const T &, const HashArbin *, const HashArbin *) {}
+
+	unsigned long long valor() const { return 0; }
+};
+
+template <>
+class HashArbin<true> {
+public:
+	HashArbin() : _valor(0) {}
+
+	/**
+	 Calcula el hash de un nodo dado su elemento y los
+	 hashes de sus hijos (NULL si el hijo es vaco). Los
+	 tres se van mezclando en orden, de modo que cambiar
+	 un hijo por el otro cambia el resultado.
+	 */
+	template <class T>
+	void calcula(const T &elem, const HashArbin *iz, const HashArbin *dr) {
+		_valor = mezcla(hashElem(elem));
+		_valor = mezcla(_valor ^ (iz ? iz->_valor : 0));
+		_valor = mezcla(_valor ^ (dr ? dr->_valor : 0) ^ 0x9e3779b97f4a7c15ULL);
+	}
+
+	unsigned long long valor() const { return _valor; }
+
+private:
+	template <class T>
+	static unsigned long long hashElem(const T &elem) {
+		return ::hash(elem);
+	}
+
+	/** FNV-1a de 64 bits sobre los bytes de la cadena. */
+	static unsigned long long hashElem(const std::string &elem) {
+		unsigned long long ret = 0xcbf29ce484222325ULL;
+		for (std::size_t i = 0; i < elem.length(); ++i) {
+			ret ^= (unsigned char)elem[i];
+			ret *= 0x100000001b3ULL;
+		}
+		return ret;
+	}
+
+	/** Funcin de mezcla de 64 bits (la de splitmix64). */
+	static unsigned long long mezcla(unsigned long long x) {
+		x += 0x9e3779b97f4a7c15ULL;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+
+	unsigned long long _valor;
+};
 
 /**
  Implementacin dinmica del TAD Arbin utilizando 
@@ -40,12 +237,41 @@
  - esVacio: Arbin -> Bool. Observadora que devuelve si
    un rbol binario es vaco.
 
+ Con el parmetro Atomico = true los contadores de
+ referencias son atmicos: se puede pasar un rbol (por
+ copia, que es O(1)) a otros hilos y que cada uno lo recorra
+ y lo destruya sin copiar los nodos. Los nodos no se
+ modifican nunca tras crearse, as que leerlos desde varios
+ hilos es seguro; lo que no debe compartirse entre hilos sin
+ sincronizar es un mismo objeto Arbin. Los contadores atmicos
+ son ms caros, por lo que por defecto no se usan.
+
+ Con el parmetro ConMedidas = true cada nodo guarda el
+ nmero de nodos, la talla y el nmero de hojas de su
+ subrbol, de modo que numNodos, talla y numHojas son O(1)
+ a cambio de tres enteros ms por nodo.
+
+ Con el parmetro ConHash = true cada nodo guarda un hash
+ estructural de 64 bits (ver HashArbin). El operador ==
+ descarta entonces en O(1) (salvo colisin, muy improbable)
+ los rboles distintos, y diferencias slo baja por los
+ subrboles cuyos hashes no coinciden. El tipo T debe tener
+ funcin hash.
+
  @author Marco Antonio Gmez Martn
  */
-template <class T>
+template <class T, bool Atomico = false, bool ConMedidas = false,
+	bool ConHash = false>
 class Arbin {
 public:
 
+	/** Tipo que devuelve reduce: el de mapea(elem). */
+	template <class M>
+	struct ResultadoReduce {
+		typedef typename std::decay<decltype(
+			std::declval<M&>()(std::declval<const T&>()))>::type Tipo;
+	};
+
 	/** Constructor; operacion ArbolVacio */
 	Arbin() : _ra(NULL) {
 	}
@@ -114,48 +340,86 @@ public:
 		return _ra == NULL;
 	}
 
+	class Vista;
+
+	/**
+	 Devuelve una vista (sin propiedad) del rbol, para
+	 recorrerlo sin crear rboles intermedios. Ver Vista.
+	 */
+	Vista vista() const {
+		return Vista(_ra);
+	}
+
 	// //
 	// RECORRIDOS SOBRE EL RBOL
 	// //
 
 	Lista<T> preorden() const {
-		Lista<T> ret;
-		preordenAcu(_ra, ret);
-		return ret;
+		return aLista(principioPreorden());
 	}
 
 	Lista<T> inorden() const {
-		Lista<T> ret;
-		inordenAcu(_ra, ret);
-		return ret;
+		return aLista(principioInorden());
 	}
 
 	Lista<T> postorden() const {
-		Lista<T> ret;
-		postordenAcu(_ra, ret);
-		return ret;
+		return aLista(principioPostorden());
 	}
 
 	Lista<T> niveles() const {
+		return aLista(principioNiveles());
+	}
 
-		if (esVacio())
-			return Lista<T>();
+	// //
+	// RECORRIDOS PEREZOSOS (ITERADORES)
+	// //
 
-		Lista<T> ret;
-		Cola<Nodo*> porProcesar;
-		porProcesar.ponDetras(_ra);
+	/*
+	 Los recorridos anteriores construyen una lista con
+	 todos los elementos. Los iteradores siguientes van
+	 generando los elementos segn se piden, de modo que se
+	 puede dejar el recorrido a medias sin haber pagado por
+	 el rbol completo. Ninguno es recursivo: guardan los
+	 nodos pendientes en una pila (o, por niveles, en una
+	 cola circular) que slo pide memoria al crecer.
 
-		while (!porProcesar.esVacia()) {
-			Nodo *visita = porProcesar.primero();
-			porProcesar.quitaPrim();
-			ret.ponDr(visita->_elem);
-			if (visita->_iz)
-				porProcesar.ponDetras(visita->_iz);
-			if (visita->_dr)
-				porProcesar.ponDetras(visita->_dr);
-		}
+	 Todos se comparan con final():
 
-		return ret;
+	   for (it = a.principioInorden(); it != a.final(); it.avanza())
+	     ... it.elem() ...
+
+	 Como los de Lista, dejan de ser vlidos si se destruye el
+	 rbol (y cualquier otro que comparta sus nodos).
+	 */
+
+	class IteradorRecorrido;
+	class IteradorPreorden;
+	class IteradorInorden;
+	class IteradorPostorden;
+	class IteradorNiveles;
+
+	IteradorPreorden principioPreorden() const {
+		return IteradorPreorden(_ra);
+	}
+
+	IteradorInorden principioInorden() const {
+		return IteradorInorden(_ra);
+	}
+
+	IteradorPostorden principioPostorden() const {
+		return IteradorPostorden(_ra);
+	}
+
+	IteradorNiveles principioNiveles() const {
+		return IteradorNiveles(_ra);
+	}
+
+	/**
+	 @return Devuelve un iterador al final de cualquiera
+	 de los recorridos (fuera de ste).
+	 */
+	IteradorRecorrido final() const {
+		return IteradorRecorrido(NULL);
 	}
 
 	// //
@@ -183,18 +447,84 @@ public:
 		return numHojasAux(_ra);
 	}
 
+	// //
+	// REDUCCIN (PARALELA) SOBRE EL RBOL
+	// //
+
+	/**
+	 Tamao mnimo (en nodos) del trabajo que reduce da a un
+	 hilo nuevo.
+	 */
+	enum { UMBRAL_PARALELO = 1 << 14 };
+
+	/**
+	 Calcula combina(... combina(mapea(e1), mapea(e2)) ...,
+	 mapea(en)) siendo e1, ..., en los elementos del rbol en
+	 inorden. combina tiene que ser asociativa (no hace falta
+	 que sea conmutativa): el resultado no depende de cmo
+	 se agrupen las llamadas. Es una operacin parcial: falla
+	 con el rbol vaco.
+
+	 Si paralelo es true, se baja desde la raz por el hijo
+	 ms grande de cada nodo, apartando el elemento del nodo
+	 con todo su hijo pequeo como un "trozo" del inorden,
+	 hasta llegar a un nodo con los dos hijos de al menos
+	 UMBRAL_PARALELO nodos. Ese nodo se reparte como en un
+	 fork-join: su hijo izquierdo en otro hilo y el derecho
+	 en el actual (cada uno, de nuevo, con esta estrategia).
+	 Los trozos apartados se agrupan en rangos seguidos de
+	 tamao parecido, cada uno para un hilo, de modo que los
+	 rboles degenerados o en peine, en los que casi todo el
+	 trabajo est en un camino, tambin se reparten. Ningn
+	 hilo recibe menos de UMBRAL_PARALELO nodos. Cada hilo
+	 recorre sus subrboles sin recursin (con un
+	 IteradorInorden).
+
+	 Para saber qu hijo es el pequeo, con ConMedidas = true
+	 basta mirar los tamaos guardados, y los hilos se
+	 reparten en proporcin a ellos. Sin medidas se cuentan
+	 los dos hijos a la vez hasta que uno termina o ambos
+	 llegan a UMBRAL_PARALELO (as que contar cuesta lo que el
+	 hijo pequeo, O(n log n) en total en el peor caso), y
+	 para repartir los hilos en una bifurcacin se cuentan
+	 como mucho hilos * UMBRAL_PARALELO nodos de cada lado.
+	 Los trozos ocupan memoria proporcional a la longitud del
+	 camino.
+
+	 mapea y combina se llaman desde varios hilos a la vez,
+	 sobre datos distintos. Si alguna lanza una excepcin se
+	 espera a todos los hilos y se relanza la primera (en
+	 inorden) en el hilo que llam a reduce.
+
+	 Los nodos no se modifican ni se tocan sus contadores de
+	 referencias, as que no hace falta Atomico. El tipo R
+	 debe tener constructor sin parmetros.
+
+	 @param mapea Funcin u objeto funcin de T en R.
+	 @param combina Funcin u objeto funcin de (R, R) en R.
+	 @param paralelo Si es true, se usan varios hilos.
+	 @return Resultado de la reduccin.
+	 */
+	template <class M, class C>
+	typename ResultadoReduce<M>::Tipo reduce(M mapea, C combina,
+	                                         bool paralelo = false) const {
+		if (esVacio())
+			throw EArbolVacio();
+		return reduceAux(_ra, mapea, combina, hilos(paralelo));
+	}
+
 	// //
 	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
 	// A LA CLASE
 	// //
 
 	/** Constructor copia */
-	Arbin(const Arbin<T> &other) : _ra(NULL) {
+	Arbin(const Arbin &other) : _ra(NULL) {
 		copia(other);
 	}
 
 	/** Operador de asignacin */
-	Arbin<T> &operator=(const Arbin<T> &other) {
+	Arbin &operator=(const Arbin &other) {
 		if (this != &other) {
 			libera();
 			copia(other);
@@ -203,14 +533,44 @@ public:
 	}
 
 	/** Operador de comparacin. */
-	bool operator==(const Arbin<T> &rhs) const {
+	bool operator==(const Arbin &rhs) const {
 		return comparaAux(_ra, rhs._ra);
 	}
 
-	bool operator!=(const Arbin<T> &rhs) const {
+	bool operator!=(const Arbin &rhs) const {
 		return !(*this == rhs);
 	}
 
+	// //
+	// DIFERENCIAS ENTRE RBOLES
+	// //
+
+	/**
+	 Devuelve las posiciones en las que este rbol y otro
+	 difieren: aquellas en las que uno tiene nodo y el otro no,
+	 o ambos tienen nodo pero con distinto elemento. Cada
+	 posicin se da como el camino desde la raz, con 'i' para
+	 bajar al hijo izquierdo y 'd' para el derecho ("" es la
+	 raz). Las posiciones que estn por debajo de un nodo que
+	 slo existe en uno de los rboles no se incluyen.
+
+	 Los subrboles compartidos no se recorren, y con
+	 ConHash = true tampoco aquellos cuyos hashes coinciden
+	 (que, salvo colisin, son iguales). As, entre dos
+	 versiones de un rbol grande con pocos cambios, el
+	 coste depende de los caminos hasta esos cambios y no
+	 del tamao del rbol.
+
+	 @param otro rbol con el que comparar.
+	 @return Lista de caminos, en preorden.
+	 */
+	Lista<std::string> diferencias(const Arbin &otro) const {
+		Lista<std::string> ret;
+		std::string camino;
+		diferenciasAux(_ra, otro._ra, camino, ret);
+		return ret;
+	}
+
 protected:
 
 	/**
@@ -220,25 +580,664 @@ protected:
 	 */
 	class Nodo {
 	public:
-		Nodo() : _iz(NULL), _dr(NULL), _numRefs(0) {}
+		Nodo() : _iz(NULL), _dr(NULL), _enArena(false) {}
 		Nodo(Nodo *iz, const T &elem, Nodo *dr) : 
-			_elem(elem), _iz(iz), _dr(dr), _numRefs(0) {
+			_elem(elem), _iz(iz), _dr(dr), _enArena(false) {
 			if (_iz != NULL)
 				_iz->addRef();
 			if (_dr != NULL)
 				_dr->addRef();
+			_medidas.calcula(_iz ? &_iz->_medidas : NULL,
+			                 _dr ? &_dr->_medidas : NULL);
+			_hash.calcula(_elem, _iz ? &_iz->_hash : NULL,
+			              _dr ? &_dr->_hash : NULL);
 		}
 
-		void addRef() { assert(_numRefs >= 0); _numRefs++; }
-		void remRef() { assert(_numRefs > 0); _numRefs--; }
+		void addRef() { _numRefs.incrementa(); }
+
+		/** Quita una referencia; devuelve true si era la ltima. */
+		bool remRef() { return _numRefs.decrementa(); }
 
 		T _elem;
 		Nodo *_iz;
 		Nodo *_dr;
 
-		int _numRefs;
+		ContadorRefs<Atomico> _numRefs;
+
+		MedidasArbin<ConMedidas> _medidas;
+
+		HashArbin<ConHash> _hash;
+
+		// true si el nodo es de una FabricaEnArena
+		bool _enArena;
+	};
+
+	/**
+	 Clave de tabla con la direccin de un nodo. La tabla
+	 usa hash % tamao, as que hacen falta bits bajos bien
+	 mezclados: con un simple hash multiplicativo, los nodos
+	 contiguos de una arena (direcciones en progresin
+	 aritmtica) caan en la quinta parte de las listas.
+	 */
+	class DirNodo {
+	public:
+		explicit DirNodo(Nodo *p) : _p(p) {}
+
+		unsigned int hash() const {
+			unsigned long long dir = reinterpret_cast<std::size_t>(_p) >> 4;
+			dir ^= dir >> 33;
+			dir *= 0xff51afd7ed558ccdULL;
+			dir ^= dir >> 33;
+			return (unsigned int)dir;
+		}
+
+		bool operator==(const DirNodo &other) const {
+			return _p == other._p;
+		}
+
+	private:
+		Nodo *_p;
+	};
+
+public:
+
+	/**
+	 Vista de slo lectura sobre un (sub)rbol. Ofrece las
+	 mismas observadoras que Arbin (raiz, iz, dr y esVacio),
+	 pero se limita a guardar el puntero al nodo: ni toca los
+	 contadores de referencias ni tiene nada que liberar al
+	 destruirse. hijoIz() e hijoDr(), en cambio, construyen un
+	 Arbin temporal (addRef y remRef) en cada llamada.
+
+	 La vista NO mantiene vivos los nodos: slo es vlida
+	 mientras exista algn Arbin que los comparta (normalmente,
+	 aquel del que se obtuvo con vista()).
+	 */
+	class Vista {
+	public:
+		/** Vista del rbol vaco. */
+		Vista() : _act(NULL) {}
+
+		/** Elemento de la raz; error si la vista es vaca. */
+		const T &raiz() const {
+			if (esVacio())
+				throw EArbolVacio();
+			return _act->_elem;
+		}
+
+		/** Vista del hijo izquierdo; error si es vaca. */
+		Vista iz() const {
+			if (esVacio())
+				throw EArbolVacio();
+			return Vista(_act->_iz);
+		}
+
+		/** Vista del hijo derecho; error si es vaca. */
+		Vista dr() const {
+			if (esVacio())
+				throw EArbolVacio();
+			return Vista(_act->_dr);
+		}
+
+		bool esVacio() const {
+			return _act == NULL;
+		}
+
+		/** Devuelve un Arbin que comparte el subrbol visto. */
+		Arbin arbin() const {
+			return Arbin(_act);
+		}
+
+	protected:
+		friend class Arbin;
+
+		Vista(Nodo *act) : _act(act) {}
+
+		Nodo *_act;
+	};
+
+	/**
+	 Parte comn de los iteradores de los recorridos: el
+	 nodo actual (NULL al terminar), el acceso a su elemento
+	 y la comparacin. final() devuelve un objeto de esta
+	 clase, con el que se compara cualquiera de ellos.
+	 */
+	class IteradorRecorrido {
+	public:
+		const T &elem() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_elem;
+		}
+
+		bool operator==(const IteradorRecorrido &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const IteradorRecorrido &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class Arbin;
+
+		IteradorRecorrido(Nodo *act) : _act(act) {}
+
+		// Puntero al nodo actual del recorrido
+		// NULL si hemos llegado al final.
+		Nodo *_act;
+	};
+
+	/**
+	 Iterador del recorrido en preorden. Se baja siempre
+	 por la izquierda, apilando los hijos derechos que
+	 quedan por visitar.
+	 */
+	class IteradorPreorden : public IteradorRecorrido {
+	public:
+		void avanza() {
+			Nodo *act = this->_act;
+			if (act == NULL) throw EAccesoInvalido();
+
+			if (act->_iz != NULL) {
+				if (act->_dr != NULL)
+					_pendientes.apila(act->_dr);
+				this->_act = act->_iz;
+			} else if (act->_dr != NULL)
+				this->_act = act->_dr;
+			else if (_pendientes.esVacia())
+				this->_act = NULL;
+			else {
+				this->_act = _pendientes.cima();
+				_pendientes.desapila();
+			}
+		}
+	protected:
+		friend class Arbin;
+
+		IteradorPreorden(Nodo *ra) : IteradorRecorrido(ra) {}
+
+		// Hijos derechos an por visitar
+		Pila<Nodo*> _pendientes;
+	};
+
+	/**
+	 Iterador del recorrido en inorden; es el mismo
+	 esquema que el iterador de Arbus.
+	 */
+	class IteradorInorden : public IteradorRecorrido {
+	public:
+		void avanza() {
+			Nodo *act = this->_act;
+			if (act == NULL) throw EAccesoInvalido();
+
+			// Si hay hijo derecho, saltamos al primero
+			// en inorden del hijo derecho; si no, al
+			// primer ascendiente no visitado
+			if (act->_dr != NULL)
+				this->_act = primeroInOrden(act->_dr);
+			else if (_ascendientes.esVacia())
+				this->_act = NULL;
+			else {
+				this->_act = _ascendientes.cima();
+				_ascendientes.desapila();
+			}
+		}
+	protected:
+		friend class Arbin;
+
+		IteradorInorden(Nodo *ra) : IteradorRecorrido(NULL) {
+			this->_act = primeroInOrden(ra);
+		}
+
+		/**
+		 Busca el primer nodo en inorden de la estructura
+		 que comienza en p, apilando sus ascendientes.
+		 */
+		Nodo *primeroInOrden(Nodo *p) {
+			if (p == NULL)
+				return NULL;
+
+			while (p->_iz != NULL) {
+				_ascendientes.apila(p);
+				p = p->_iz;
+			}
+			return p;
+		}
+
+		// Ascendientes del nodo actual
+		// an por visitar
+		Pila<Nodo*> _ascendientes;
+	};
+
+	/**
+	 Iterador del recorrido en postorden. En la pila estn
+	 los ascendientes del nodo actual junto con el lado por
+	 el que se baj a l. No basta con comparar el nodo del
+	 que venimos con _iz, porque al compartir estructura un
+	 mismo nodo puede ser a la vez hijo izquierdo y derecho.
+	 */
+	class IteradorPostorden : public IteradorRecorrido {
+	public:
+		void avanza() {
+			if (this->_act == NULL) throw EAccesoInvalido();
+
+			if (_ascendientes.esVacia()) {
+				this->_act = NULL;
+				return;
+			}
+
+			Ascendiente padre = _ascendientes.cima();
+			_ascendientes.desapila();
+			if (padre._porIz && (padre._nodo->_dr != NULL)) {
+				// Terminamos el hijo izquierdo; falta el derecho
+				_ascendientes.apila(Ascendiente(padre._nodo, false));
+				this->_act = primeroPostOrden(padre._nodo->_dr);
+			} else
+				this->_act = padre._nodo;
+		}
+	protected:
+		friend class Arbin;
+
+		IteradorPostorden(Nodo *ra) : IteradorRecorrido(NULL) {
+			this->_act = primeroPostOrden(ra);
+		}
+
+		struct Ascendiente {
+			Ascendiente() : _nodo(NULL), _porIz(false) {}
+			Ascendiente(Nodo *nodo, bool porIz) :
+				_nodo(nodo), _porIz(porIz) {}
+
+			Nodo *_nodo;
+			// true si se baj por el hijo izquierdo
+			bool _porIz;
+		};
+
+		/**
+		 Busca el primer nodo en postorden de la estructura
+		 que comienza en p (la primera hoja, bajando por la
+		 izquierda siempre que se pueda), apilando los
+		 ascendientes.
+		 */
+		Nodo *primeroPostOrden(Nodo *p) {
+			if (p == NULL)
+				return NULL;
+
+			for (;;) {
+				if (p->_iz != NULL) {
+					_ascendientes.apila(Ascendiente(p, true));
+					p = p->_iz;
+				} else if (p->_dr != NULL) {
+					_ascendientes.apila(Ascendiente(p, false));
+					p = p->_dr;
+				} else
+					return p;
+			}
+		}
+
+		Pila<Ascendiente> _ascendientes;
 	};
 
+	/**
+	 Iterador del recorrido por niveles. Los nodos
+	 pendientes se guardan en una cola circular, que como
+	 mucho contiene dos niveles del rbol.
+	 */
+	class IteradorNiveles : public IteradorRecorrido {
+	public:
+		void avanza() {
+			Nodo *act = this->_act;
+			if (act == NULL) throw EAccesoInvalido();
+
+			if (act->_iz != NULL)
+				_pendientes.ponDetras(act->_iz);
+			if (act->_dr != NULL)
+				_pendientes.ponDetras(act->_dr);
+
+			if (_pendientes.esVacia())
+				this->_act = NULL;
+			else {
+				this->_act = _pendientes.primero();
+				_pendientes.quitaPrim();
+			}
+		}
+	protected:
+		friend class Arbin;
+
+		IteradorNiveles(Nodo *ra) : IteradorRecorrido(ra) {}
+
+		ColaCircular<Nodo*> _pendientes;
+	};
+
+	/**
+	 Fbrica de rboles con "hash-consing": cons construye
+	 Cons(iz, elem, dr) pero, si la fbrica ya haba construido
+	 un nodo con los mismos hijos (los mismos nodos, no slo
+	 iguales) y el mismo elemento, lo reutiliza en lugar de
+	 crear otro. As, si todos los rboles de la fbrica se
+	 construyen con ella, cada subrbol distinto existe una
+	 nica vez, y dos de esos rboles son iguales si y slo si
+	 comparten la raz (ver iguales). Los rboles con mucha
+	 estructura repetida ocupan adems mucho menos.
+
+	 Los nodos se guardan en una Tabla, que mantiene una
+	 referencia a cada uno, de modo que viven (al menos)
+	 mientras viva la fbrica: aunque se descarten todos los
+	 rboles que los usan, la memoria no se recupera hasta
+	 que se llama a purga o se destruye la fbrica. Al
+	 destruirla se quitan esas referencias y los rboles que
+	 sigan en uso fuera de ella siguen siendo vlidos. La
+	 fbrica no se puede copiar y no se debe usar desde varios
+	 hilos a la vez.
+
+	 El tipo T debe tener funcin hash (ver Hash.h) y ==.
+	 */
+	class Fabrica {
+	public:
+		Fabrica() {}
+
+		/** Destructor; suelta las referencias de la tabla. */
+		~Fabrica() {
+			typename Tabla<ClaveNodo, Nodo*>::Iterador it = _nodos.principio();
+			for (; it != _nodos.final(); it.avanza())
+				Arbin::libera(it.valor());
+		}
+
+		/**
+		 Operacin Cons con comparticin de los subrboles
+		 repetidos.
+		 @return rbol igual a Arbin(iz, elem, dr).
+		 */
+		Arbin cons(const Arbin &iz, const T &elem, const Arbin &dr) {
+			Nodo **existente = _nodos.busca(ClaveNodo(iz._ra, &elem, dr._ra));
+			if (existente != NULL)
+				return Arbin(*existente);
+
+			Nodo *nuevo = new Nodo(iz._ra, elem, dr._ra);
+			nuevo->addRef(); // La referencia de la tabla
+			_nodos.inserta(ClaveNodo(nuevo), nuevo);
+			return Arbin(nuevo);
+		}
+
+		/**
+		 Libera los nodos que ya slo usa la fbrica (los de
+		 rboles que se han descartado). Al liberar uno, sus
+		 hijos pueden quedarse tambin slo con la referencia
+		 de la fbrica, y se liberan a continuacin. O(nodos
+		 de la fbrica).
+		 @return Nmero de nodos liberados.
+		 */
+		unsigned int purga() {
+			Pila<Nodo*> pendientes;
+			typename Tabla<ClaveNodo, Nodo*>::Iterador it = _nodos.principio();
+			for (; it != _nodos.final(); it.avanza())
+				if (it.valor()->_numRefs.valor() == 1)
+					pendientes.apila(it.valor());
+
+			unsigned int ret = 0;
+			while (!pendientes.esVacia()) {
+				Nodo *p = pendientes.cima();
+				pendientes.desapila();
+
+				// Un hijo de la fbrica con dos referencias (la
+				// de la tabla y la de p; tres si es a la vez el
+				// izquierdo y el derecho) se queda slo con la
+				// de la tabla al liberar p. Cada nodo llega a una
+				// referencia una nica vez, as que no se apila
+				// dos veces.
+				Nodo *iz = p->_iz;
+				Nodo *dr = p->_dr;
+				_nodos.borra(ClaveNodo(p));
+				if ((iz != NULL) && (iz->_numRefs.valor() == (iz == dr ? 3 : 2)) &&
+					esDeLaFabrica(iz))
+					pendientes.apila(iz);
+				if ((dr != NULL) && (dr != iz) && (dr->_numRefs.valor() == 2) &&
+					esDeLaFabrica(dr))
+					pendientes.apila(dr);
+				Arbin::libera(p);
+				++ret;
+			}
+			return ret;
+		}
+
+		/**
+		 Compara dos rboles construidos con la misma fbrica
+		 en O(1). Con rboles de otra procedencia no es
+		 fiable (puede devolver false con rboles iguales);
+		 para ellos est el operador ==.
+		 */
+		static bool iguales(const Arbin &a, const Arbin &b) {
+			return a._ra == b._ra;
+		}
+
+	private:
+		Fabrica(const Fabrica &);
+		Fabrica &operator=(const Fabrica &);
+
+		/** Indica si un nodo es el que guarda la tabla. */
+		bool esDeLaFabrica(Nodo *p) {
+			Nodo **guardado = _nodos.busca(ClaveNodo(p));
+			return (guardado != NULL) && (*guardado == p);
+		}
+
+		/**
+		 Clave de la tabla: los dos hijos (por direccin) y
+		 el elemento de un nodo. El elemento no se copia: las
+		 claves guardadas apuntan al del propio nodo, y las que
+		 se usan para buscar, al que se recibe en cons.
+		 */
+		class ClaveNodo {
+		public:
+			ClaveNodo(Nodo *iz, const T *elem, Nodo *dr) :
+				_iz(iz), _elem(elem), _dr(dr) {}
+
+			explicit ClaveNodo(Nodo *p) :
+				_iz(p->_iz), _elem(&p->_elem), _dr(p->_dr) {}
+
+			unsigned int hash() const {
+				unsigned int ret = ::hash(*_elem);
+				ret = ret * 31 + DirNodo(_iz).hash();
+				ret = ret * 31 + DirNodo(_dr).hash();
+				return ret;
+			}
+
+			bool operator==(const ClaveNodo &other) const {
+				return (_iz == other._iz) && (_dr == other._dr) &&
+					(*_elem == *other._elem);
+			}
+
+		private:
+			Nodo *_iz;
+			const T *_elem;
+			Nodo *_dr;
+		};
+
+		Tabla<ClaveNodo, Nodo*> _nodos;
+	};
+
+	/**
+	 Fbrica que reserva los nodos en bloques contiguos de una
+	 Arena, pensada para construir de golpe rboles grandes
+	 (por ejemplo, al leerlos de la entrada) que luego se
+	 descartan enteros. En lugar de un new por nodo y de una
+	 liberacin recursiva nodo a nodo, los nodos se reparten
+	 en orden de construccin por los bloques de la arena y
+	 al destruir la fbrica se liberan los bloques de una vez:
+	 O(nmero de bloques) si T no necesita destructor.
+
+	 Cada nodo de la fbrica tiene una referencia de la propia
+	 fbrica, as que los Arbin que lo comparten nunca lo
+	 liberan; a cambio, TODOS esos Arbin deben destruirse (o
+	 asignarse otro rbol) antes que la fbrica. Para quedarse
+	 con un rbol ms all de la fbrica est extrae, que lo
+	 copia a nodos normales con conteo de referencias.
+
+	 Los rboles de la fbrica pueden tener como hijos rboles
+	 normales (que se comparten, como en Cons) y viceversa. La
+	 fbrica no se puede copiar.
+	 */
+	class FabricaEnArena {
+	public:
+		FabricaEnArena() {}
+
+		/** Destructor; libera todos los nodos de la fbrica. */
+		~FabricaEnArena() {
+			liberaTodo();
+		}
+
+		/**
+		 Operacin Cons con el nodo nuevo en la arena.
+		 @return rbol igual a Arbin(iz, elem, dr).
+		 */
+		Arbin cons(const Arbin &iz, const T &elem, const Arbin &dr) {
+			Nodo *nuevo = new (_arena.reserva()) Nodo(iz._ra, elem, dr._ra);
+			nuevo->_enArena = true;
+			nuevo->addRef(); // La referencia de la fbrica
+
+			// Las referencias a nodos de fuera hay que
+			// quitarlas al liberar la arena
+			if ((iz._ra != NULL) && !iz._ra->_enArena)
+				_externos.apila(iz._ra);
+			if ((dr._ra != NULL) && !dr._ra->_enArena)
+				_externos.apila(dr._ra);
+			if (!std::is_trivially_destructible<T>::value)
+				_nodos.apila(nuevo);
+
+			return Arbin(nuevo);
+		}
+
+		/**
+		 Devuelve un rbol igual a a que no depende de la
+		 fbrica: sus nodos de la arena se copian en nodos
+		 normales (los que no son de la arena se comparten).
+		 */
+		Arbin extrae(const Arbin &a) const {
+			return Arbin(extraeAux(a._ra));
+		}
+
+		/**
+		 Libera todos los nodos de la fbrica, que queda
+		 como recin creada. Los rboles que los usaban
+		 tienen que haberse destruido ya.
+		 */
+		void liberaTodo() {
+			while (!_nodos.esVacia()) {
+				_nodos.cima()->~Nodo();
+				_nodos.desapila();
+			}
+			while (!_externos.esVacia()) {
+				Arbin::libera(_externos.cima());
+				_externos.desapila();
+			}
+			_arena.liberaTodo();
+		}
+
+	private:
+		FabricaEnArena(const FabricaEnArena &);
+		FabricaEnArena &operator=(const FabricaEnArena &);
+
+		/**
+		 Copia (fuera de la arena) la estructura que empieza
+		 en p. El nodo devuelto an no tiene la referencia de
+		 quien lo vaya a usar.
+
+		 Recorrido en postorden con pila explcita (las cadenas
+		 de la arena pueden ser muy profundas); las copias se
+		 van apilando y cada nodo recoge de la cima las de sus
+		 hijos. Un nodo de la arena con ms de una referencia
+		 aparte de la de la fbrica puede alcanzarse por varios
+		 caminos: su copia se apunta en una tabla para hacerla
+		 slo una vez.
+
+		 Mientras dura, cada copia tiene adems una referencia
+		 propia del recorrido; si una copia falla, soltarlas de
+		 la ltima a la primera libera todo lo copiado sin
+		 recursin en cadena.
+		 */
+		static Nodo *extraeAux(Nodo *p) {
+			if ((p == NULL) || !p->_enArena)
+				return p;
+
+			Tabla<DirNodo, Nodo*> compartidos;
+			Pila<Nodo*> hechas; // Todas las copias, en orden de creacin
+			Pila<Nodo*> resultados;
+			Pila<Pendiente> pendientes;
+			pendientes.apila(Pendiente(p, false));
+			try {
+				while (!pendientes.esVacia()) {
+					Pendiente act = pendientes.cima();
+					pendientes.desapila();
+					Nodo *n = act._nodo;
+					if ((n == NULL) || !n->_enArena) {
+						resultados.apila(n);
+						continue;
+					}
+					bool compartido = n->_numRefs.valor() > 2;
+					if (compartido) {
+						Nodo **copia = compartidos.busca(DirNodo(n));
+						if (copia != NULL) {
+							resultados.apila(*copia);
+							continue;
+						}
+					}
+					if (!act._hijosHechos) {
+						pendientes.apila(Pendiente(n, true));
+						pendientes.apila(Pendiente(n->_dr, false));
+						pendientes.apila(Pendiente(n->_iz, false));
+						continue;
+					}
+
+					Nodo *dr = resultados.cima();
+					resultados.desapila();
+					Nodo *iz = resultados.cima();
+					resultados.desapila();
+					Nodo *copia = new Nodo(iz, n->_elem, dr);
+					copia->addRef();
+					hechas.apila(copia);
+					if (compartido)
+						compartidos.inserta(DirNodo(n), copia);
+					resultados.apila(copia);
+				}
+			} catch (...) {
+				while (!hechas.esVacia()) {
+					Arbin::libera(hechas.cima());
+					hechas.desapila();
+				}
+				throw;
+			}
+
+			// Slo la raz se queda sin referencias
+			Nodo *ret = resultados.cima();
+			while (!hechas.esVacia()) {
+				hechas.cima()->remRef();
+				hechas.desapila();
+			}
+			return ret;
+		}
+
+		/** Nodo pendiente del recorrido de extraeAux. */
+		struct Pendiente {
+			Pendiente() : _nodo(NULL), _hijosHechos(false) {}
+			Pendiente(Nodo *nodo, bool hijosHechos) :
+				_nodo(nodo), _hijosHechos(hijosHechos) {}
+
+			Nodo *_nodo;
+			// true si ya se apilaron (y copiaron) sus hijos
+			bool _hijosHechos;
+		};
+
+		Arena<Nodo> _arena;
+
+		/** Nodos de fuera de la arena que son hijos de nodos de ella. */
+		Pila<Nodo*> _externos;
+
+		/**
+		 Nodos de la arena, para llamar a su destructor (slo
+		 si T lo necesita).
+		 */
+		Pila<Nodo*> _nodos;
+	};
+
+protected:
+
 	/**
 	 Constructor protegido que crea un rbol
 	 a partir de una estructura jerrquica existente.
@@ -265,32 +1264,16 @@ protected:
 	// //
 	// MTODOS AUXILIARES PARA LOS RECORRIDOS
 	// //
-	
-	static void preordenAcu(Nodo *ra, Lista<T> &acu) {
-		if (ra == NULL)
-			return;
-
-		acu.ponDr(ra->_elem);
-		preordenAcu(ra->_iz, acu);
-		preordenAcu(ra->_dr, acu);
-	}
-
-	static void inordenAcu(Nodo *ra, Lista<T> &acu) {
-		if (ra == NULL)
-			return;
 
-		inordenAcu(ra->_iz, acu);
-		acu.ponDr(ra->_elem);
-		inordenAcu(ra->_dr, acu);
-	}
-
-	static void postordenAcu(Nodo *ra, Lista<T> &acu) {
-		if (ra == NULL)
-			return;
-
-		postordenAcu(ra->_iz, acu);
-		postordenAcu(ra->_dr, acu);
-		acu.ponDr(ra->_elem);
+	/**
+	 Vuelca en una lista lo que queda de un recorrido.
+	 */
+	template <class Iterador>
+	Lista<T> aLista(Iterador it) const {
+		Lista<T> ret;
+		for (; it != final(); it.avanza())
+			ret.ponDr(it.elem());
+		return ret;
 	}
 
 	// //
@@ -301,12 +1284,16 @@ protected:
 	static unsigned int numNodosAux(Nodo *ra) {
 		if (ra == NULL)
 			return 0;
+		if (ConMedidas)
+			return ra->_medidas.numNodos();
 		return 1 + numNodosAux(ra->_iz) + numNodosAux(ra->_dr);
 	}
 
 	static unsigned int tallaAux(Nodo *ra) {
 		if (ra == NULL)
 			return 0;
+		if (ConMedidas)
+			return ra->_medidas.talla();
 
 		int tallaiz = tallaAux(ra->_iz);
 		int talladr = tallaAux(ra->_dr);
@@ -319,6 +1306,8 @@ protected:
 	static unsigned int numHojasAux(Nodo *ra) {
 		if (ra == NULL)
 			return 0;
+		if (ConMedidas)
+			return ra->_medidas.numHojas();
 
 		if ((ra->_iz == NULL) && (ra->_dr == NULL))
 			return 1;
@@ -336,8 +1325,7 @@ private:
 	 */
 	static void libera(Nodo *ra) {
 		if (ra != NULL) {
-			ra->remRef();
-			if (ra->_numRefs == 0) {
+			if (ra->remRef()) {
 				libera(ra->_iz);
 				libera(ra->_dr);
 				delete ra;
@@ -358,6 +1346,9 @@ private:
 			// otro entonces no lo ser, luego
 			// son distintos.
 			return false;
+		else if (ConHash && (r1->_hash.valor() != r2->_hash.valor()))
+			// Hashes distintos: seguro que son distintos
+			return false;
 		else {
 			return (r1->_elem == r2->_elem) &&
 				comparaAux(r1->_iz, r2->_iz) &&
@@ -365,6 +1356,446 @@ private:
 		}
 	}
 
+	// //
+	// REDUCCIN PARALELA
+	// //
+
+	/**
+	 Nmero de hilos con el que empieza reduce: 1 si no
+	 se pide paralelismo; si no, los ncleos disponibles.
+	 */
+	static unsigned int hilos(bool paralelo) {
+		if (!paralelo)
+			return 1;
+		unsigned int n = std::thread::hardware_concurrency();
+		return n > 0 ? n : 2;
+	}
+
+	/**
+	 Trozo del inorden de reduce: el elemento de un nodo
+	 precedido de todo su hijo izquierdo (conIz) o seguido
+	 de todo su hijo derecho (!conIz). tam es su nmero de
+	 nodos.
+	 */
+	struct Trozo {
+		Trozo() : _nodo(NULL), _conIz(false), _tam(0) {}
+		Trozo(Nodo *nodo, bool conIz, std::size_t tam) :
+			_nodo(nodo), _conIz(conIz), _tam(tam) {}
+
+		Nodo *_nodo;
+		bool _conIz;
+		std::size_t _tam;
+	};
+
+	/**
+	 Tarea de reduce para un hilo: un rango [ini, fin) de
+	 trozos, o el nodo en el que se bifurca el recorrido.
+	 */
+	template <class R>
+	struct TareaReduce {
+		TareaReduce() : _ini(0), _fin(0), _bifurca(false), _res() {}
+
+		std::size_t _ini;
+		std::size_t _fin;
+		bool _bifurca;
+		R _res;
+		std::exception_ptr _error;
+		std::thread _hilo;
+	};
+
+	/**
+	 Trozos y tareas de una llamada a reduceAux. El
+	 destructor espera a los hilos que sigan en marcha, de
+	 modo que nunca se destruye un std::thread sin join
+	 (lo que terminara el programa) aunque salte una
+	 excepcin.
+	 */
+	template <class R>
+	struct RepartoReduce {
+		RepartoReduce(std::size_t numTrozos, unsigned int maxTareas) :
+			_trozos(new Trozo[numTrozos]),
+			_tareas(new TareaReduce<R>[maxTareas]), _numTareas(0) {}
+
+		~RepartoReduce() {
+			for (unsigned int i = 0; i < _numTareas; ++i)
+				if (_tareas[i]._hilo.joinable())
+					_tareas[i]._hilo.join();
+			delete []_tareas;
+			delete []_trozos;
+		}
+
+		Trozo *_trozos;
+		TareaReduce<R> *_tareas;
+		unsigned int _numTareas;
+
+	private:
+		RepartoReduce(const RepartoReduce &);
+		RepartoReduce &operator=(const RepartoReduce &);
+	};
+
+	/** Qu hijo de un nodo es pequeo para reduceAux. */
+	enum HijoPequeno { IZ_PEQUENO, DR_PEQUENO, AMBOS_GRANDES };
+
+	/**
+	 Reparte hilos (al menos 2) entre dos trabajos de
+	 tamaos a y b en proporcin a ellos, dejando al menos
+	 uno para cada uno.
+	 @return Hilos para el trabajo de tamao a.
+	 */
+	static unsigned int reparte(unsigned int hilos, std::size_t a, std::size_t b) {
+		unsigned int ret = (unsigned int)((double) hilos * a / (a + b));
+		if (ret < 1) ret = 1;
+		if (ret > hilos - 1) ret = hilos - 1;
+		return ret;
+	}
+
+	/**
+	 Decide qu hijo de p es pequeo (menos de
+	 UMBRAL_PARALELO nodos) y cuntos nodos tiene. Sin
+	 ConMedidas los dos hijos se cuentan a la vez, con una
+	 pila cada uno (que se reciben para no reservarlas en
+	 cada nodo y se devuelven vacas), hasta que uno termina
+	 o los dos llegan al umbral.
+	 @param tam Tamao del hijo pequeo (salida).
+	 */
+	static HijoPequeno clasificaHijos(Nodo *p, std::size_t &tam,
+	                                  Pila<Nodo*> &pilaIz, Pila<Nodo*> &pilaDr) {
+		if (ConMedidas) {
+			std::size_t nIz = numNodosAux(p->_iz);
+			std::size_t nDr = numNodosAux(p->_dr);
+			if ((nIz >= UMBRAL_PARALELO) && (nDr >= UMBRAL_PARALELO))
+				return AMBOS_GRANDES;
+			tam = nIz <= nDr ? nIz : nDr;
+			return nIz <= nDr ? IZ_PEQUENO : DR_PEQUENO;
+		}
+
+		// Hijos vacos y hojas (los de los rboles degenerados
+		// y en peine), sin pilas
+		if (esHojaOVacio(p->_iz)) {
+			tam = p->_iz == NULL ? 0 : 1;
+			return IZ_PEQUENO;
+		}
+		if (esHojaOVacio(p->_dr)) {
+			tam = p->_dr == NULL ? 0 : 1;
+			return DR_PEQUENO;
+		}
+
+		std::size_t nIz = 0, nDr = 0;
+		if (p->_iz != NULL)
+			pilaIz.apila(p->_iz);
+		if (p->_dr != NULL)
+			pilaDr.apila(p->_dr);
+		HijoPequeno ret;
+		while (true) {
+			if (pilaIz.esVacia()) {
+				tam = nIz;
+				ret = IZ_PEQUENO;
+				break;
+			}
+			if (pilaDr.esVacia()) {
+				tam = nDr;
+				ret = DR_PEQUENO;
+				break;
+			}
+			if ((nIz >= UMBRAL_PARALELO) && (nDr >= UMBRAL_PARALELO)) {
+				ret = AMBOS_GRANDES;
+				break;
+			}
+			if (nIz < UMBRAL_PARALELO)
+				cuentaSiguiente(pilaIz, nIz);
+			if (nDr < UMBRAL_PARALELO)
+				cuentaSiguiente(pilaDr, nDr);
+		}
+		while (!pilaIz.esVacia())
+			pilaIz.desapila();
+		while (!pilaDr.esVacia())
+			pilaDr.desapila();
+		return ret;
+	}
+
+	/**
+	 Tamao de la estructura que comienza en p para repartir
+	 hilos: el exacto con ConMedidas y, sin medidas, contando
+	 como mucho hasta limite.
+	 */
+	static std::size_t tamanoHasta(Nodo *p, std::size_t limite) {
+		if (ConMedidas)
+			return numNodosAux(p);
+
+		std::size_t n = 0;
+		Pila<Nodo*> pila;
+		if (p != NULL)
+			pila.apila(p);
+		while (!pila.esVacia() && (n < limite))
+			cuentaSiguiente(pila, n);
+		return n;
+	}
+
+	static bool esHojaOVacio(Nodo *p) {
+		return (p == NULL) || ((p->_iz == NULL) && (p->_dr == NULL));
+	}
+
+	/** Un paso del recorrido en preorden que cuenta nodos. */
+	static void cuentaSiguiente(Pila<Nodo*> &pila, std::size_t &n) {
+		Nodo *p = pila.cima();
+		pila.desapila();
+		++n;
+		if (p->_iz != NULL)
+			pila.apila(p->_iz);
+		if (p->_dr != NULL)
+			pila.apila(p->_dr);
+	}
+
+	/**
+	 Reduccin de la estructura (no vaca) que comienza en
+	 p usando como mucho el nmero de hilos dado.
+	 */
+	template <class M, class C>
+	static typename ResultadoReduce<M>::Tipo
+	reduceAux(Nodo *p, M &mapea, C &combina, unsigned int hilos) {
+		typedef typename ResultadoReduce<M>::Tipo R;
+
+		if (hilos <= 1)
+			return reduceSecuencial(p, mapea, combina);
+
+		// Se baja por el hijo grande apartando los trozos
+		// con el pequeo: antes los que van antes (en
+		// inorden) que el resto del camino, y despues los
+		// que van detrs, en orden inverso
+		Pila<Trozo> antes, despues;
+		Pila<Nodo*> pilaIz, pilaDr;
+		std::size_t tam = 0;
+		Nodo *bifurca = NULL;
+		for (Nodo *act = p; act != NULL; ) {
+			std::size_t tamHijo = 0;
+			HijoPequeno pequeno = clasificaHijos(act, tamHijo, pilaIz, pilaDr);
+			if (pequeno == AMBOS_GRANDES) {
+				bifurca = act;
+				break;
+			}
+			tam += 1 + tamHijo;
+			if (pequeno == IZ_PEQUENO) {
+				antes.apila(Trozo(act, true, 1 + tamHijo));
+				act = act->_dr;
+			} else {
+				despues.apila(Trozo(act, false, 1 + tamHijo));
+				act = act->_iz;
+			}
+		}
+
+		if ((bifurca == NULL) && (tam < 2 * UMBRAL_PARALELO))
+			return reduceSecuencial(p, mapea, combina);
+		if (tam == 0)
+			return reduceBifurca(bifurca, mapea, combina, hilos);
+
+		// Hilos para los trozos, con al menos UMBRAL_PARALELO
+		// nodos cada uno; los dems, para bifurca
+		unsigned int hilosTrozos = hilos;
+		if (bifurca != NULL)
+			hilosTrozos = tam < UMBRAL_PARALELO ? 0 :
+				reparte(hilos, tam, tamanoHasta(bifurca, hilos * UMBRAL_PARALELO));
+		if (hilosTrozos > tam / UMBRAL_PARALELO)
+			hilosTrozos = (unsigned int)(tam / UMBRAL_PARALELO);
+		unsigned int hilosBifurca = hilos - hilosTrozos;
+
+		// Los trozos, en inorden, con bifurca entre los de
+		// antes y los de despues
+		std::size_t numAntes = antes.numElems();
+		std::size_t numTrozos = numAntes + despues.numElems();
+		RepartoReduce<R> reparto(numTrozos, hilosTrozos + 3);
+		for (std::size_t i = numAntes; i > 0; --i) {
+			reparto._trozos[i - 1] = antes.cima();
+			antes.desapila();
+		}
+		for (std::size_t i = numAntes; i < numTrozos; ++i) {
+			reparto._trozos[i] = despues.cima();
+			despues.desapila();
+		}
+
+		// Rangos de unos tam / hilosTrozos nodos, cortando
+		// siempre donde va bifurca
+		std::size_t objetivo = hilosTrozos > 0 ? tam / hilosTrozos : tam;
+		std::size_t ini = 0, acumulado = 0, siguienteCorte = objetivo;
+		unsigned int principal = 0;
+		for (std::size_t i = 0; i <= numTrozos; ++i) {
+			bool corta = (i == numTrozos) || (i == numAntes) ||
+				(acumulado >= siguienteCorte);
+			if (corta && (i > ini)) {
+				TareaReduce<R> &t = reparto._tareas[reparto._numTareas++];
+				t._ini = ini;
+				t._fin = i;
+				ini = i;
+				while (siguienteCorte <= acumulado)
+					siguienteCorte += objetivo;
+			}
+			if ((i == numAntes) && (bifurca != NULL)) {
+				principal = reparto._numTareas;
+				reparto._tareas[reparto._numTareas++]._bifurca = true;
+			}
+			if (i < numTrozos)
+				acumulado += reparto._trozos[i]._tam;
+		}
+
+		// Cada rango, en un hilo (si hay hilos para ellos); el
+		// hilo actual se queda con bifurca o, si no hay, con
+		// el primer rango
+		for (unsigned int i = 0; i < reparto._numTareas; ++i) {
+			TareaReduce<R> &t = reparto._tareas[i];
+			if ((i == principal) || (hilosTrozos == 0))
+				continue;
+			t._hilo = std::thread([&t, &reparto, &mapea, &combina]() {
+				try {
+					t._res = reduceTrozos(reparto._trozos, t._ini, t._fin,
+					                      mapea, combina);
+				} catch (...) {
+					t._error = std::current_exception();
+				}
+			});
+		}
+		for (unsigned int i = 0; i < reparto._numTareas; ++i) {
+			TareaReduce<R> &t = reparto._tareas[i];
+			if ((i != principal) && (hilosTrozos != 0))
+				continue;
+			try {
+				if (t._bifurca)
+					t._res = reduceBifurca(bifurca, mapea, combina, hilosBifurca);
+				else
+					t._res = reduceTrozos(reparto._trozos, t._ini, t._fin,
+					                      mapea, combina);
+			} catch (...) {
+				t._error = std::current_exception();
+			}
+		}
+
+		for (unsigned int i = 0; i < reparto._numTareas; ++i)
+			if (reparto._tareas[i]._hilo.joinable())
+				reparto._tareas[i]._hilo.join();
+		for (unsigned int i = 0; i < reparto._numTareas; ++i)
+			if (reparto._tareas[i]._error)
+				std::rethrow_exception(reparto._tareas[i]._error);
+
+		R ret = reparto._tareas[0]._res;
+		for (unsigned int i = 1; i < reparto._numTareas; ++i)
+			ret = combina(ret, reparto._tareas[i]._res);
+		return ret;
+	}
+
+	/**
+	 Reduce un nodo con los dos hijos grandes: el izquierdo
+	 en un hilo nuevo y el centro y el derecho en el actual.
+	 */
+	template <class M, class C>
+	static typename ResultadoReduce<M>::Tipo
+	reduceBifurca(Nodo *p, M &mapea, C &combina, unsigned int hilos) {
+		typedef typename ResultadoReduce<M>::Tipo R;
+
+		if (hilos <= 1)
+			return reduceSecuencial(p, mapea, combina);
+
+		std::size_t limite = hilos * UMBRAL_PARALELO;
+		unsigned int hilosIz = reparte(hilos, tamanoHasta(p->_iz, limite),
+		                               tamanoHasta(p->_dr, limite));
+		R iz = R();
+		std::exception_ptr error;
+		std::thread hiloIz([&]() {
+			try {
+				iz = reduceAux(p->_iz, mapea, combina, hilosIz);
+			} catch (...) {
+				error = std::current_exception();
+			}
+		});
+		R centro = R(), dr = R();
+		try {
+			centro = mapea(p->_elem);
+			dr = reduceAux(p->_dr, mapea, combina, hilos - hilosIz);
+		} catch (...) {
+			hiloIz.join();
+			throw;
+		}
+		hiloIz.join();
+		if (error)
+			std::rethrow_exception(error);
+		return combina(combina(iz, centro), dr);
+	}
+
+	/**
+	 Reduccin secuencial de los trozos [ini, fin) (al
+	 menos uno).
+	 */
+	template <class M, class C>
+	static typename ResultadoReduce<M>::Tipo
+	reduceTrozos(const Trozo *trozos, std::size_t ini, std::size_t fin,
+	             M &mapea, C &combina) {
+		typedef typename ResultadoReduce<M>::Tipo R;
+
+		R ret = reduceTrozo(trozos[ini], mapea, combina);
+		for (std::size_t i = ini + 1; i < fin; ++i)
+			ret = combina(ret, reduceTrozo(trozos[i], mapea, combina));
+		return ret;
+	}
+
+	/** Reduccin secuencial de un trozo: su nodo y su hijo. */
+	template <class M, class C>
+	static typename ResultadoReduce<M>::Tipo
+	reduceTrozo(const Trozo &trozo, M &mapea, C &combina) {
+		typedef typename ResultadoReduce<M>::Tipo R;
+
+		Nodo *p = trozo._nodo;
+		Nodo *hijo = trozo._conIz ? p->_iz : p->_dr;
+		R ret = mapea(p->_elem);
+		if (hijo == NULL)
+			return ret;
+		return trozo._conIz ?
+			combina(reduceSecuencial(hijo, mapea, combina), ret) :
+			combina(ret, reduceSecuencial(hijo, mapea, combina));
+	}
+
+	/**
+	 Reduccin secuencial (y no recursiva) de la
+	 estructura no vaca que comienza en p.
+	 */
+	template <class M, class C>
+	static typename ResultadoReduce<M>::Tipo
+	reduceSecuencial(Nodo *p, M &mapea, C &combina) {
+		typedef typename ResultadoReduce<M>::Tipo R;
+
+		// Las hojas (muchos de los trozos de reduceAux) no
+		// necesitan el iterador ni su pila
+		if ((p->_iz == NULL) && (p->_dr == NULL))
+			return mapea(p->_elem);
+
+		IteradorInorden it(p);
+		R ret = mapea(it.elem());
+		for (it.avanza(); it != IteradorRecorrido(NULL); it.avanza())
+			ret = combina(ret, mapea(it.elem()));
+		return ret;
+	}
+
+	/**
+	 Aade a acu las diferencias entre las estructuras que
+	 comienzan en r1 y r2, que estn en la posicin camino.
+	 */
+	static void diferenciasAux(Nodo *r1, Nodo *r2, std::string &camino,
+	                           Lista<std::string> &acu) {
+		if (r1 == r2)
+			return;
+		if ((r1 == NULL) || (r2 == NULL)) {
+			acu.ponDr(camino);
+			return;
+		}
+		if (ConHash && (r1->_hash.valor() == r2->_hash.valor()))
+			return;
+
+		if (!(r1->_elem == r2->_elem))
+			acu.ponDr(camino);
+
+		camino.push_back('i');
+		diferenciasAux(r1->_iz, r2->_iz, camino, acu);
+		camino[camino.size() - 1] = 'd';
+		diferenciasAux(r1->_dr, r2->_dr, camino, acu);
+		camino.erase(camino.size() - 1);
+	}
+
 protected:
 	/** 
 	 Puntero a la raz de la estructura jerrquica
@@ -373,4 +1804,12 @@ protected:
 	Nodo *_ra;
 };
 
+/**
+ Nombre corto para la vista de un Arbin; por ejemplo
+ ArbinVista<int> en lugar de Arbin<int>::Vista.
+ */
+template <class T, bool Atomico = false, bool ConMedidas = false,
+	bool ConHash = false>
+using ArbinVista = typename Arbin<T, Atomico, ConMedidas, ConHash>::Vista;
+
 #endif // __ARBIN_H
@@ -0,0 +1,429 @@
+/**
+  @file ArbinArray.h
+
+  Implementacin del TAD Arbol Binario con los nodos
+  guardados por niveles en un vector (representacin
+  implcita, como la de los montculos).
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBINARRAY_H
+#define __ARBINARRAY_H
+
+#include "Excepciones.h"
+
+#include "Lista.h" // Tipo devuelto por los recorridos
+
+#include "ColaCircular.h" // Nodos pendientes al convertir desde Arbin
+
+#include "Arbin.h" // Conversin desde y hacia Arbin
+
+#include <cstddef>
+
+/**
+ Variante de Arbin pensada para rboles completos o casi
+ completos (montculos, rboles de expresiones equilibrados,
+ ...). No hay nodos ni punteros: los elementos se guardan en
+ un vector en el orden del recorrido por niveles, con la
+ raz en la posicin 0 y los hijos de la posicin i en las
+ posiciones 2i + 1 y 2i + 2. Un mapa de bits indica qu
+ posiciones tienen nodo, de modo que tambin se admiten
+ rboles con huecos. El recorrido por niveles es entonces
+ un recorrido secuencial del vector.
+
+ El vector ocupa tantas posiciones como indique el ltimo
+ nodo, hasta 2^talla - 1; por eso slo merece la pena con
+ rboles (casi) completos, y no se admiten rboles de talla
+ mayor que TALLA_MAXIMA ni rboles cuyo vector tendra ms
+ de POSICIONES_POR_NODO posiciones por nodo (una espina de
+ 24 nodos ocupara 2^24 posiciones), salvo que el vector sea
+ pequeo (hasta POSICIONES_LIBRES posiciones).
+
+ Los rboles se construyen convirtiendo un Arbin, y se pueden
+ volver a convertir en Arbin con aArbin. Como no hay Cons, un
+ ArbinArray no se modifica nunca: hijoIz e hijoDr comparten
+ el vector con el rbol original (con conteo de referencias,
+ no seguro entre hilos), cambiando slo la posicin de la
+ raz. T debe tener constructor sin parmetros.
+ */
+template <class T>
+class ArbinArray {
+public:
+
+	/** Talla mxima de los rboles que se pueden guardar. */
+	enum { TALLA_MAXIMA = 32 };
+
+	/**
+	 Mximo de posiciones del vector por nodo del rbol;
+	 acota la memoria de los rboles con muchos huecos.
+	 */
+	enum { POSICIONES_POR_NODO = 4 };
+
+	/** Tamao del vector que se admite siempre, haya los nodos que haya. */
+	enum { POSICIONES_LIBRES = 64 };
+
+	/** Constructor; operacion ArbolVacio */
+	ArbinArray() : _datos(NULL), _ra(0) {
+	}
+
+	/**
+	 Constructor que guarda en el vector los nodos de un Arbin.
+	 @param a rbol a convertir; su talla no debe superar
+	 TALLA_MAXIMA, y la posicin de su ltimo nodo ms uno
+	 no debe superar a la vez POSICIONES_LIBRES y
+	 POSICIONES_POR_NODO veces su nmero de nodos. Se
+	 comprueba antes de reservar el vector.
+	 */
+	template <bool Atomico, bool ConMedidas, bool ConHash>
+	explicit ArbinArray(const Arbin<T, Atomico, ConMedidas, ConHash> &a) :
+		_datos(NULL), _ra(0) {
+		typedef typename Arbin<T, Atomico, ConMedidas, ConHash>::Vista Vista;
+
+		if (a.esVacio())
+			return;
+
+		// Primera pasada: posicin del ltimo nodo, que
+		// determina el tamao del vector, y nmero de nodos.
+		// La talla se comprueba por el camino: las posiciones
+		// del nivel TALLA_MAXIMA empiezan en 2^TALLA_MAXIMA - 1
+		const unsigned long long primeraFuera =
+			(1ULL << TALLA_MAXIMA) - 1;
+		ColaCircular<Vista> pendientes;
+		ColaCircular<unsigned long long> posiciones;
+		unsigned long long ultima = 0, numNodos = 0;
+		pendientes.ponDetras(a.vista());
+		posiciones.ponDetras(0);
+		while (!pendientes.esVacia()) {
+			Vista v = pendientes.primero();
+			unsigned long long pos = posiciones.primero();
+			pendientes.quitaPrim();
+			posiciones.quitaPrim();
+			if (pos >= primeraFuera)
+				throw EAccesoInvalido("Arbol demasiado alto para ArbinArray");
+			ultima = pos;
+			++numNodos;
+			if (!v.iz().esVacio()) {
+				pendientes.ponDetras(v.iz());
+				posiciones.ponDetras(2 * pos + 1);
+			}
+			if (!v.dr().esVacio()) {
+				pendientes.ponDetras(v.dr());
+				posiciones.ponDetras(2 * pos + 2);
+			}
+		}
+		if ((ultima + 1 > POSICIONES_LIBRES) &&
+		    (ultima + 1 > POSICIONES_POR_NODO * numNodos))
+			throw EAccesoInvalido("Arbol demasiado disperso para ArbinArray");
+
+		// Segunda pasada: se copian los elementos
+		_datos = new Datos((unsigned int)(ultima + 1));
+		_datos->_numRefs = 1;
+		pendientes.ponDetras(a.vista());
+		posiciones.ponDetras(0);
+		while (!pendientes.esVacia()) {
+			Vista v = pendientes.primero();
+			unsigned long long pos = posiciones.primero();
+			pendientes.quitaPrim();
+			posiciones.quitaPrim();
+			_datos->pon((unsigned int) pos, v.raiz());
+			if (!v.iz().esVacio()) {
+				pendientes.ponDetras(v.iz());
+				posiciones.ponDetras(2 * pos + 1);
+			}
+			if (!v.dr().esVacio()) {
+				pendientes.ponDetras(v.dr());
+				posiciones.ponDetras(2 * pos + 2);
+			}
+		}
+	}
+
+	/** Destructor; suelta el vector si nadie ms lo usa. */
+	~ArbinArray() {
+		libera();
+	}
+
+	/**
+	 Devuelve el elemento almacenado en la raiz
+
+	 raiz(Cons(iz, elem, dr)) = elem
+	 error raiz(ArbolVacio)
+	 @return Elemento en la raz.
+	 */
+	const T &raiz() const {
+		if (esVacio())
+			throw EArbolVacio();
+		return _datos->_elems[_ra];
+	}
+
+	/**
+	 Devuelve el hijo izquierdo, que comparte el vector.
+	 Es una operacin parcial (falla con el rbol vaco).
+
+	 hijoIz(Cons(iz, elem, dr)) = iz
+	 error hijoIz(ArbolVacio)
+	*/
+	ArbinArray hijoIz() const {
+		if (esVacio())
+			throw EArbolVacio();
+		return ArbinArray(_datos, 2 * (unsigned long long) _ra + 1);
+	}
+
+	/**
+	 Devuelve el hijo derecho, que comparte el vector.
+	 Es una operacin parcial (falla con el rbol vaco).
+
+	 hijoDr(Cons(iz, elem, dr)) = dr
+	 error hijoDr(ArbolVacio)
+	*/
+	ArbinArray hijoDr() const {
+		if (esVacio())
+			throw EArbolVacio();
+		return ArbinArray(_datos, 2 * (unsigned long long) _ra + 2);
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+
+	 esVacio(ArbolVacio) = true
+	 esVacio(Cons(iz, elem, dr)) = false
+	 */
+	bool esVacio() const {
+		return !ocupada(_ra);
+	}
+
+	/**
+	 Devuelve un Arbin con los mismos elementos en las
+	 mismas posiciones.
+	 */
+	template <bool Atomico = false, bool ConMedidas = false, bool ConHash = false>
+	Arbin<T, Atomico, ConMedidas, ConHash> aArbin() const {
+		return aArbinAux<Atomico, ConMedidas, ConHash>(_ra);
+	}
+
+	// //
+	// RECORRIDOS SOBRE EL RBOL
+	// //
+
+	Lista<T> preorden() const {
+		Lista<T> ret;
+		preordenAcu(_ra, ret);
+		return ret;
+	}
+
+	Lista<T> inorden() const {
+		Lista<T> ret;
+		inordenAcu(_ra, ret);
+		return ret;
+	}
+
+	Lista<T> postorden() const {
+		Lista<T> ret;
+		postordenAcu(_ra, ret);
+		return ret;
+	}
+
+	/**
+	 Recorrido por niveles. Los nodos del nivel k del
+	 subrbol que empieza en la posicin r ocupan las
+	 posiciones consecutivas desde (r + 1) * 2^k - 1 hasta
+	 (r + 2) * 2^k - 2, as que basta con recorrer esos
+	 tramos del vector, sin cola.
+	 */
+	Lista<T> niveles() const {
+		Lista<T> ret;
+		if (esVacio())
+			return ret;
+
+		unsigned long long ini = _ra, ancho = 1;
+		while (ini < _datos->_tam) {
+			unsigned long long fin = ini + ancho;
+			if (fin > _datos->_tam)
+				fin = _datos->_tam;
+			for (unsigned long long i = ini; i < fin; ++i)
+				if (_datos->ocupada((unsigned int) i))
+					ret.ponDr(_datos->_elems[i]);
+			ini = 2 * ini + 1;
+			ancho *= 2;
+		}
+		return ret;
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbinArray(const ArbinArray &other) : _datos(NULL), _ra(0) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbinArray &operator=(const ArbinArray &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+	/** Operador de comparacin. */
+	bool operator==(const ArbinArray &rhs) const {
+		return comparaAux(_ra, rhs, rhs._ra);
+	}
+
+	bool operator!=(const ArbinArray &rhs) const {
+		return !(*this == rhs);
+	}
+
+protected:
+
+	/**
+	 Vector de elementos y mapa de bits de posiciones
+	 ocupadas, compartido por un rbol y sus subrboles.
+	 */
+	class Datos {
+	public:
+		Datos(unsigned int tam) : _elems(new T[tam]),
+			_ocupadas(new unsigned int[palabras(tam)]),
+			_tam(tam), _numRefs(0) {
+			for (std::size_t i = 0; i < palabras(tam); ++i)
+				_ocupadas[i] = 0;
+		}
+
+		~Datos() {
+			delete []_elems;
+			delete []_ocupadas;
+		}
+
+		void pon(unsigned int pos, const T &elem) {
+			_elems[pos] = elem;
+			_ocupadas[pos / 32] |= 1u << (pos % 32);
+		}
+
+		bool ocupada(unsigned int pos) const {
+			return (_ocupadas[pos / 32] >> (pos % 32)) & 1;
+		}
+
+		/**
+		 Palabras del mapa de bits para tam posiciones; en
+		 64 bits, porque tam + 31 desborda cerca de 2^32.
+		 */
+		static std::size_t palabras(unsigned int tam) {
+			return (std::size_t)(((unsigned long long) tam + 31) / 32);
+		}
+
+		T *_elems;
+		unsigned int *_ocupadas;
+		unsigned int _tam;
+		int _numRefs;
+
+	private:
+		Datos(const Datos &);
+		Datos &operator=(const Datos &);
+	};
+
+	/**
+	 Constructor protegido de un subrbol que comparte
+	 el vector datos. Se utiliza en hijoIz e hijoDr.
+	 */
+	ArbinArray(Datos *datos, unsigned long long ra) : _datos(datos), _ra(0) {
+		// Las posiciones que no caben en el vector son
+		// rboles vacos; se normalizan a la 0 de ningn
+		// vector
+		if (ra >= _datos->_tam)
+			_datos = NULL;
+		else {
+			_ra = (unsigned int) ra;
+			_datos->_numRefs++;
+		}
+	}
+
+	void libera() {
+		if ((_datos != NULL) && (--_datos->_numRefs == 0))
+			delete _datos;
+		_datos = NULL;
+	}
+
+	void copia(const ArbinArray &other) {
+		_datos = other._datos;
+		_ra = other._ra;
+		if (_datos != NULL)
+			_datos->_numRefs++;
+	}
+
+	/** Indica si hay nodo en la posicin pos. */
+	bool ocupada(unsigned long long pos) const {
+		return (_datos != NULL) && (pos < _datos->_tam) &&
+			_datos->ocupada((unsigned int) pos);
+	}
+
+	// //
+	// MTODOS AUXILIARES (RECURSIVOS); LA PROFUNDIDAD
+	// EST LIMITADA POR TALLA_MAXIMA
+	// //
+
+	void preordenAcu(unsigned long long pos, Lista<T> &acu) const {
+		if (!ocupada(pos))
+			return;
+
+		acu.ponDr(_datos->_elems[pos]);
+		preordenAcu(2 * pos + 1, acu);
+		preordenAcu(2 * pos + 2, acu);
+	}
+
+	void inordenAcu(unsigned long long pos, Lista<T> &acu) const {
+		if (!ocupada(pos))
+			return;
+
+		inordenAcu(2 * pos + 1, acu);
+		acu.ponDr(_datos->_elems[pos]);
+		inordenAcu(2 * pos + 2, acu);
+	}
+
+	void postordenAcu(unsigned long long pos, Lista<T> &acu) const {
+		if (!ocupada(pos))
+			return;
+
+		postordenAcu(2 * pos + 1, acu);
+		postordenAcu(2 * pos + 2, acu);
+		acu.ponDr(_datos->_elems[pos]);
+	}
+
+	template <bool Atomico, bool ConMedidas, bool ConHash>
+	Arbin<T, Atomico, ConMedidas, ConHash> aArbinAux(unsigned long long pos) const {
+		typedef Arbin<T, Atomico, ConMedidas, ConHash> A;
+		if (!ocupada(pos))
+			return A();
+		return A(aArbinAux<Atomico, ConMedidas, ConHash>(2 * pos + 1),
+		         _datos->_elems[pos],
+		         aArbinAux<Atomico, ConMedidas, ConHash>(2 * pos + 2));
+	}
+
+	/**
+	 Compara el subrbol de la posicin pos con el de la
+	 posicin posOtro de otro.
+	 */
+	bool comparaAux(unsigned long long pos, const ArbinArray &otro,
+	                unsigned long long posOtro) const {
+		bool hay = ocupada(pos);
+		if (hay != otro.ocupada(posOtro))
+			return false;
+		if (!hay)
+			return true;
+		return (_datos->_elems[pos] == otro._datos->_elems[posOtro]) &&
+			comparaAux(2 * pos + 1, otro, 2 * posOtro + 1) &&
+			comparaAux(2 * pos + 2, otro, 2 * posOtro + 2);
+	}
+
+	/** Vector compartido; NULL en el rbol vaco. */
+	Datos *_datos;
+
+	/** Posicin de la raz en el vector. */
+	unsigned int _ra;
+};
+
+#endif // __ARBINARRAY_H
@@ -0,0 +1,514 @@
+/**
+  @file ArbinCompacto.h
+
+  Implementacin del TAD Arbol Binario con los nodos
+  en un vector y los hijos direccionados por ndices de
+  32 bits.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBINCOMPACTO_H
+#define __ARBINCOMPACTO_H
+
+#include "Excepciones.h"
+
+#include "Lista.h" // Tipo devuelto por los recorridos
+
+#include "Cola.h" // Tipo auxiliar para implementar el recorrido por niveles
+
+#include "Pila.h" // Nodos pendientes en libera
+
+#include "PoolIndices.h" // Almacn de los nodos
+
+/**
+ Variante de Arbin con la misma interfaz y el mismo
+ comportamiento (comparticin de estructura con conteo de
+ referencias) en la que los nodos no se reservan por
+ separado con new, sino que se guardan en un PoolIndices,
+ y los hijos se identifican por ndices de 32 bits. Para
+ elementos pequeos (Arbin<int>) cada nodo pasa de 24 bytes
+ ms la cabecera de new a 16 bytes, y los nodos quedan
+ juntos en memoria, lo que favorece a los recorridos.
+
+ Como Cons enlaza sus hijos por ndice, los dos tienen
+ que estar en el mismo almacn. Los rboles se agrupan en
+ familias, cada una con su almacn (un objeto Almacen):
+
+ - Un rbol vaco construido con ArbinCompacto(almacen)
+   pertenece a esa familia, y Cons pone el nodo nuevo en
+   el almacn de sus hijos. Hacer Cons con hijos de dos
+   familias distintas es un error (EAccesoInvalido).
+ - El rbol vaco de ArbinCompacto() no es de ninguna
+   familia y vale como hijo de cualquiera. Si los dos
+   hijos de Cons son de sos, el nodo va al almacn por
+   defecto del hilo que lo construye (thread_local).
+
+ Cada rbol mantiene vivo su almacn, que se libera
+ entero cuando desaparece el ltimo rbol (o Almacen) que
+ lo usa. Un almacn y los rboles que guarda no son seguros
+ entre hilos: una familia slo se puede usar desde un hilo
+ a la vez, y no se pueden mezclar en Cons rboles
+ construidos en hilos distintos con el almacn por
+ defecto. Hilos que construyen rboles independientes no
+ interfieren entre s.
+
+ Como los nodos pueden cambiar de sitio cuando el vector
+ crece, la referencia devuelta por raiz() deja de ser vlida
+ al construir otro rbol de la misma familia. Cada familia
+ admite hasta 2^31 - 1 nodos. T debe tener constructor sin
+ parmetros.
+ */
+template <class T>
+class ArbinCompacto {
+protected:
+	/** ndice de 32 bits de un nodo en el almacn. */
+	typedef unsigned int Indice;
+
+	/**
+	 Clase nodo que almacena internamente el elemento (de tipo T),
+	 los ndices del hijo izquierdo y del hijo derecho, y
+	 el nmero de referencias que hay.
+	 */
+	class Nodo {
+	public:
+		Nodo() : _iz(NULO), _dr(NULO), _numRefs(0) {}
+		Nodo(Indice iz, const T &elem, Indice dr) :
+			_elem(elem), _iz(iz), _dr(dr), _numRefs(0) {}
+
+		T _elem;
+		Indice _iz;
+		Indice _dr;
+
+		unsigned int _numRefs;
+	};
+
+	enum { NULO = PoolIndices<Nodo>::NULO };
+
+	/**
+	 Almacn de una familia de rboles, compartido (con
+	 conteo de referencias) por todos ellos.
+	 */
+	class DatosAlmacen {
+	public:
+		DatosAlmacen() : _numRefs(0) {}
+
+		PoolIndices<Nodo> _nodos;
+		unsigned int _numRefs;
+	};
+
+public:
+
+	/**
+	 Almacn de los nodos de una familia de rboles. Las
+	 copias de un Almacen son la misma familia.
+	 */
+	class Almacen {
+	public:
+		/** Constructor; crea una familia nueva, sin nodos. */
+		Almacen() : _datos(new DatosAlmacen()) {
+			_datos->_numRefs++;
+		}
+
+		~Almacen() {
+			ArbinCompacto::suelta(_datos);
+		}
+
+		/** Nmero de nodos guardados en el almacn. */
+		unsigned int numNodos() const {
+			return _datos->_nodos.numElems();
+		}
+
+		Almacen(const Almacen &other) : _datos(other._datos) {
+			_datos->_numRefs++;
+		}
+
+		Almacen &operator=(const Almacen &other) {
+			other._datos->_numRefs++;
+			ArbinCompacto::suelta(_datos);
+			_datos = other._datos;
+			return *this;
+		}
+
+	protected:
+		friend class ArbinCompacto;
+
+		DatosAlmacen *_datos;
+	};
+
+	/** Constructor; operacion ArbolVacio */
+	ArbinCompacto() : _ra(NULO), _almacen(NULL) {
+	}
+
+	/**
+	 Constructor; operacion ArbolVacio de una familia
+	 concreta: los rboles que se construyan con Cons a
+	 partir de l guardarn sus nodos en almacen.
+	 */
+	explicit ArbinCompacto(const Almacen &almacen) :
+		_ra(NULO), _almacen(almacen._datos) {
+		_almacen->_numRefs++;
+	}
+
+	/** Constructor; operacion Cons */
+	ArbinCompacto(const ArbinCompacto &iz, const T &elem, const ArbinCompacto &dr) {
+		DatosAlmacen *almacen = iz._almacen != NULL ? iz._almacen : dr._almacen;
+		if (almacen == NULL)
+			almacen = almacenDelHilo()._datos;
+		else if ((dr._almacen != NULL) && (dr._almacen != almacen))
+			throw EAccesoInvalido("Cons con hijos de almacenes distintos");
+
+		// Las referencias se toman cuando el nodo ya est
+		// reservado: si reserva lanza, no hay nada que soltar
+		Indice nuevo = almacen->_nodos.reserva(Nodo(iz._ra, elem, dr._ra));
+		_almacen = almacen;
+		_almacen->_numRefs++;
+		addRef(iz._ra);
+		addRef(dr._ra);
+		_ra = nuevo;
+		addRef(_ra);
+	}
+
+	/** Destructor; elimina la estructura jerrquica de nodos. */
+	~ArbinCompacto() {
+		libera();
+		_ra = NULO;
+	}
+
+	/**
+	 Devuelve el elemento almacenado en la raiz
+
+	 raiz(Cons(iz, elem, dr)) = elem
+	 error raiz(ArbolVacio)
+	 @return Elemento en la raz.
+	 */
+	const T &raiz() const {
+		if (esVacio())
+			throw EArbolVacio();
+		return nodos()[_ra]._elem;
+	}
+
+	/**
+	 Devuelve un rbol copia del rbol izquierdo.
+	 Es una operacin parcial (falla con el rbol vaco).
+
+	 hijoIz(Cons(iz, elem, dr)) = iz
+	 error hijoIz(ArbolVacio)
+	*/
+	ArbinCompacto hijoIz() const {
+		if (esVacio())
+			throw EArbolVacio();
+
+		return ArbinCompacto(nodos()[_ra]._iz, _almacen);
+	}
+
+	/**
+	 Devuelve un rbol copia del rbol derecho.
+	 Es una operacin parcial (falla con el rbol vaco).
+
+	 hijoDr(Cons(iz, elem, dr)) = dr
+	 error hijoDr(ArbolVacio)
+	*/
+	ArbinCompacto hijoDr() const {
+		if (esVacio())
+			throw EArbolVacio();
+
+		return ArbinCompacto(nodos()[_ra]._dr, _almacen);
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+
+	 esVacio(ArbolVacio) = true
+	 esVacio(Cons(iz, elem, dr)) = false
+	 */
+	bool esVacio() const {
+		return _ra == NULO;
+	}
+
+	// //
+	// RECORRIDOS SOBRE EL RBOL
+	// //
+
+	Lista<T> preorden() const {
+		Lista<T> ret;
+		preordenAcu(_ra, ret);
+		return ret;
+	}
+
+	Lista<T> inorden() const {
+		Lista<T> ret;
+		inordenAcu(_ra, ret);
+		return ret;
+	}
+
+	Lista<T> postorden() const {
+		Lista<T> ret;
+		postordenAcu(_ra, ret);
+		return ret;
+	}
+
+	Lista<T> niveles() const {
+
+		if (esVacio())
+			return Lista<T>();
+
+		Lista<T> ret;
+		Cola<Indice> porProcesar;
+		porProcesar.ponDetras(_ra);
+
+		while (!porProcesar.esVacia()) {
+			const Nodo &visita = nodos()[porProcesar.primero()];
+			porProcesar.quitaPrim();
+			ret.ponDr(visita._elem);
+			if (visita._iz != NULO)
+				porProcesar.ponDetras(visita._iz);
+			if (visita._dr != NULO)
+				porProcesar.ponDetras(visita._dr);
+		}
+
+		return ret;
+	}
+
+	// //
+	// OTRAS OPERACIONES OBSERVADORAS
+	// //
+
+	/**
+	 Devuelve el nmero de nodos de un rbol.
+	 */
+	unsigned int numNodos() const {
+		return numNodosAux(_ra);
+	}
+
+	/**
+	 Devuelve la talla del rbol.
+	 */
+	unsigned int talla() const {
+		return tallaAux(_ra);
+	}
+
+	/**
+	 Devuelve el nmero de hojas de un rbol.
+	 */
+	unsigned int numHojas() const {
+		return numHojasAux(_ra);
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbinCompacto(const ArbinCompacto<T> &other) : _ra(NULO), _almacen(NULL) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbinCompacto<T> &operator=(const ArbinCompacto<T> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+	/** Operador de comparacin. */
+	bool operator==(const ArbinCompacto<T> &rhs) const {
+		return comparaAux(_ra, rhs, rhs._ra);
+	}
+
+	bool operator!=(const ArbinCompacto<T> &rhs) const {
+		return !(*this == rhs);
+	}
+
+protected:
+
+	/**
+	 Almacn por defecto del hilo actual, para los nodos
+	 construidos slo a partir de rboles vacos sin
+	 familia. Cada rbol que lo usa lo mantiene vivo, as que
+	 no importa en qu orden se destruyan al terminar el
+	 hilo o el programa.
+	 */
+	static Almacen &almacenDelHilo() {
+		static thread_local Almacen almacen;
+		return almacen;
+	}
+
+	/**
+	 Quita una referencia a un almacn (que puede ser
+	 NULL) y lo libera si era la ltima.
+	 */
+	static void suelta(DatosAlmacen *almacen) {
+		if ((almacen != NULL) && (--almacen->_numRefs == 0))
+			delete almacen;
+	}
+
+	/** Nodos del almacn del rbol (que no puede ser vaco). */
+	PoolIndices<Nodo> &nodos() const {
+		return _almacen->_nodos;
+	}
+
+	void addRef(Indice i) const {
+		if (i != NULO)
+			nodos()[i]._numRefs++;
+	}
+
+	/**
+	 Constructor protegido que crea un rbol
+	 a partir de una estructura jerrquica existente.
+	 Esa estructura jerrquica SE COMPARTE, por lo que
+	 se aade la referencia.
+	 Se utiliza en hijoIz e hijoDr.
+	 */
+	ArbinCompacto(Indice raiz, DatosAlmacen *almacen) :
+		_ra(raiz), _almacen(almacen) {
+		_almacen->_numRefs++;
+		addRef(_ra);
+	}
+
+	void libera() {
+		if (_almacen != NULL)
+			libera(_ra);
+		suelta(_almacen);
+		_almacen = NULL;
+	}
+
+	void copia(const ArbinCompacto &other) {
+		assert(this != &other);
+		_ra = other._ra;
+		_almacen = other._almacen;
+		if (_almacen != NULL)
+			_almacen->_numRefs++;
+		addRef(_ra);
+	}
+
+	// //
+	// MTODOS AUXILIARES PARA LOS RECORRIDOS
+	// //
+
+	void preordenAcu(Indice ra, Lista<T> &acu) const {
+		if (ra == NULO)
+			return;
+
+		acu.ponDr(nodos()[ra]._elem);
+		preordenAcu(nodos()[ra]._iz, acu);
+		preordenAcu(nodos()[ra]._dr, acu);
+	}
+
+	void inordenAcu(Indice ra, Lista<T> &acu) const {
+		if (ra == NULO)
+			return;
+
+		inordenAcu(nodos()[ra]._iz, acu);
+		acu.ponDr(nodos()[ra]._elem);
+		inordenAcu(nodos()[ra]._dr, acu);
+	}
+
+	void postordenAcu(Indice ra, Lista<T> &acu) const {
+		if (ra == NULO)
+			return;
+
+		postordenAcu(nodos()[ra]._iz, acu);
+		postordenAcu(nodos()[ra]._dr, acu);
+		acu.ponDr(nodos()[ra]._elem);
+	}
+
+	// //
+	// MTODOS AUXILIARES (RECURSIVOS) DE OTRAS OPERACIONES
+	// OBSERVADORAS
+	// //
+
+	unsigned int numNodosAux(Indice ra) const {
+		if (ra == NULO)
+			return 0;
+		return 1 + numNodosAux(nodos()[ra]._iz) + numNodosAux(nodos()[ra]._dr);
+	}
+
+	unsigned int tallaAux(Indice ra) const {
+		if (ra == NULO)
+			return 0;
+
+		unsigned int tallaiz = tallaAux(nodos()[ra]._iz);
+		unsigned int talladr = tallaAux(nodos()[ra]._dr);
+		if (tallaiz > talladr)
+			return 1 + tallaiz;
+		else
+			return 1 + talladr;
+	}
+
+	unsigned int numHojasAux(Indice ra) const {
+		if (ra == NULO)
+			return 0;
+
+		const Nodo &n = nodos()[ra];
+		if ((n._iz == NULO) && (n._dr == NULO))
+			return 1;
+
+		return numHojasAux(n._iz) + numHojasAux(n._dr);
+	}
+
+private:
+
+	/**
+	 Quita una referencia a la estructura que comienza
+	 en ra y devuelve al almacn los nodos que se quedan
+	 sin referencias. Se admite que ra sea NULO.
+	 */
+	void libera(Indice ra) {
+		Pila<Indice> pendientes;
+		pendientes.apila(ra);
+		while (!pendientes.esVacia()) {
+			Indice i = pendientes.cima();
+			pendientes.desapila();
+			if (i == NULO)
+				continue;
+
+			Nodo &n = nodos()[i];
+			assert(n._numRefs > 0);
+			if (--n._numRefs == 0) {
+				pendientes.apila(n._iz);
+				pendientes.apila(n._dr);
+				nodos().devuelve(i);
+			}
+		}
+	}
+
+	/**
+	 Compara dos estructuras jerrquicas de nodos,
+	 dadas sus raices (que pueden ser NULO): r1 en este
+	 rbol y r2 en otro, que puede ser de otra familia.
+	 */
+	bool comparaAux(Indice r1, const ArbinCompacto &otro, Indice r2) const {
+		if ((r1 == r2) && ((r1 == NULO) || (_almacen == otro._almacen)))
+			return true;
+		else if ((r1 == NULO) || (r2 == NULO))
+			return false;
+		else {
+			const Nodo &n1 = nodos()[r1];
+			const Nodo &n2 = otro.nodos()[r2];
+			return (n1._elem == n2._elem) &&
+				comparaAux(n1._iz, otro, n2._iz) &&
+				comparaAux(n1._dr, otro, n2._dr);
+		}
+	}
+
+protected:
+	/**
+	 ndice de la raz de la estructura jerrquica
+	 de nodos; NULO si el rbol es vaco.
+	 */
+	Indice _ra;
+
+	/**
+	 Almacn de la familia del rbol; NULL si es un rbol
+	 vaco que no pertenece a ninguna.
+	 */
+	DatosAlmacen *_almacen;
+};
+
+#endif // __ARBINCOMPACTO_H
@@ -0,0 +1,743 @@
+/**
+  @file ArbinSucinto.h
+
+  Representacin sucinta (de slo lectura) de rboles
+  binarios muy grandes: la forma del rbol en unos 2 bits
+  por nodo con parntesis equilibrados, y los elementos
+  seguidos en un vector.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBINSUCINTO_H
+#define __ARBINSUCINTO_H
+
+#include "Excepciones.h"
+
+#include "Lista.h" // Tipo devuelto por los recorridos
+
+#include "Pila.h" // Subrboles pendientes al construir y al convertir
+
+#include "Arbin.h" // Conversin desde y hacia Arbin
+
+#include <istream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ rbol binario inmutable pensado para rboles con cientos de
+ millones de nodos, que con Arbin (dos punteros, contador de
+ referencias y cabecera de new por nodo) no caben en memoria.
+
+ La forma del rbol se guarda como una secuencia de
+ parntesis equilibrados (un bit por parntesis, 1 = abre,
+ 0 = cierra). El rbol binario se ve como un bosque, en el
+ que el hijo izquierdo de un nodo es su primer hijo y el
+ hijo derecho su siguiente hermano; ese bosque, colgado de
+ una raz ficticia, se escribe en preorden abriendo un
+ parntesis al entrar en cada nodo y cerrndolo al salir:
+
+   cod(ArbolVacio) = ""
+   cod(Cons(iz, e, dr)) = "(" cod(iz) ")" cod(dr)
+   secuencia = "(" cod(arbol) ")"
+
+ Son 2n + 2 bits para n nodos. Cada nodo se identifica por
+ la posicin de su parntesis abierto, y los nodos quedan en
+ preorden, que es el orden en el que se guardan los
+ elementos. Para navegar se usan:
+
+ - rango(k): unos en las k primeras posiciones. Con el
+   nmero de unos al principio de cada bloque de
+   BITS_BLOQUE bits, es O(1).
+ - El exceso E(k) = abiertos - cerrados en las k primeras
+   posiciones, que vale 2 rango(k) - k. El parntesis que
+   cierra el abierto en p est en la primera k > p con
+   E(k) = E(p), menos uno; el que abre el cerrado en c, en
+   la ltima k <= c con E(k) = E(c + 1). Esas bsquedas
+   recorren a saltos de byte (con tablas) el bloque en el que
+   empiezan, localizan el siguiente (o anterior) bloque que
+   alcanza el exceso buscado con un rbol de mnimos por
+   bloques, O(log n), y terminan dentro de ese bloque.
+
+ Con eso, en la Vista de un nodo: iz es O(1); dr, padre y
+ numNodos (del subrbol) son O(log n). Los ndices y
+ mnimos aaden unos 0,6 bits por nodo a la forma.
+
+ Se construye desde un Arbin o leyendo de un flujo el
+ formato de leeArbolEnPreorden (el elemento de la raz, el
+ hijo izquierdo y el derecho, con una marca para el rbol
+ vaco), sin recursin y sin crear nodos. Como ArbinArray,
+ las copias comparten los datos (con conteo de referencias,
+ no seguro entre hilos). T debe tener constructor sin
+ parmetros.
+ */
+template <class T>
+class ArbinSucinto {
+public:
+
+	/** Posicin en la secuencia de parntesis. */
+	typedef unsigned long long Posicion;
+
+	/** Bits de cada bloque del ndice de rangos y mnimos. */
+	enum { BITS_BLOQUE = 1024 };
+
+	/** Constructor; operacion ArbolVacio */
+	ArbinSucinto() : _datos(NULL) {
+	}
+
+	/**
+	 Constructor que codifica un Arbin.
+	 @param a rbol a codificar.
+	 */
+	template <bool Atomico, bool ConMedidas, bool ConHash>
+	explicit ArbinSucinto(const Arbin<T, Atomico, ConMedidas, ConHash> &a) :
+		_datos(NULL) {
+		typedef typename Arbin<T, Atomico, ConMedidas, ConHash>::Vista Vista;
+
+		// Mismo esquema que al leer de un flujo, pero
+		// apilando los hijos derechos en lugar de leerlos
+		Constructor c;
+		Pila<Vista> derechos;
+		Vista act = a.vista();
+		for (;;) {
+			if (!act.esVacio()) {
+				c.abre(act.raiz());
+				derechos.apila(act.dr());
+				act = act.iz();
+			} else if (derechos.esVacia())
+				break;
+			else {
+				c.cierra();
+				act = derechos.cima();
+				derechos.desapila();
+			}
+		}
+		_datos = c.termina();
+	}
+
+	/**
+	 Constructor que lee un rbol en preorden: el elemento de
+	 la raz seguido del hijo izquierdo y del derecho, y
+	 marcaVacio para el rbol vaco (por ejemplo, con enteros
+	 y marca -1, "5 7 -1 -1 -1" es Cons(Cons(vacio, 7, vacio),
+	 5, vacio)).
+
+	 Para eso no hace falta una pila: tras leer un nodo se lee
+	 su hijo izquierdo, y cuando un subrbol termina (se lee
+	 una marca) se cierra el ltimo nodo abierto y se sigue
+	 leyendo su hijo derecho. Basta con contar los nodos
+	 abiertos; cuando no queda ninguno, el rbol ha terminado.
+
+	 @param is Flujo del que leer.
+	 @param marcaVacio Valor que representa el rbol vaco.
+	 */
+	ArbinSucinto(std::istream &is, const T &marcaVacio) : _datos(NULL) {
+		Constructor c;
+		Posicion abiertos = 0;
+		T elem;
+		while (is >> elem) {
+			if (!(elem == marcaVacio)) {
+				c.abre(elem);
+				++abiertos;
+			} else if (abiertos == 0)
+				break;
+			else {
+				c.cierra();
+				--abiertos;
+			}
+		}
+		if (abiertos != 0)
+			throw EAccesoInvalido("Arbol incompleto en la entrada");
+		_datos = c.termina();
+	}
+
+	/** Destructor; suelta los datos si nadie ms los usa. */
+	~ArbinSucinto() {
+		libera();
+	}
+
+	class Vista;
+
+	/** Devuelve la vista de la raz del rbol. */
+	Vista vista() const {
+		if (_datos == NULL)
+			return Vista();
+		return Vista(_datos, 1);
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _datos == NULL;
+	}
+
+	/**
+	 Devuelve el nmero de nodos del rbol.
+	 */
+	Posicion numNodos() const {
+		return _datos == NULL ? 0 : _datos->_numNodos;
+	}
+
+	/**
+	 Recorrido en preorden; los elementos estn guardados
+	 en ese orden, as que es un recorrido secuencial.
+	 */
+	Lista<T> preorden() const {
+		Lista<T> ret;
+		for (Posicion i = 0; i < numNodos(); ++i)
+			ret.ponDr(_datos->_elems[i]);
+		return ret;
+	}
+
+	/**
+	 Devuelve un Arbin igual al rbol codificado.
+
+	 No es recursivo: se recorren los nodos en preorden
+	 inverso (derecho, izquierdo, raz), de modo que al llegar
+	 a un nodo sus hijos izquierdo y derecho ya estn
+	 construidos, en la cima de una pila y debajo de ella.
+	 */
+	template <bool Atomico = false, bool ConMedidas = false, bool ConHash = false>
+	Arbin<T, Atomico, ConMedidas, ConHash> aArbin() const {
+		typedef Arbin<T, Atomico, ConMedidas, ConHash> A;
+		if (esVacio())
+			return A();
+
+		Pila<A> hechos;
+		Posicion i = numNodos();
+		for (Posicion p = _datos->_numBits - 1; p > 0; --p) {
+			if (!_datos->bit(p))
+				continue;
+			--i;
+			A iz, dr;
+			if (_datos->bit(p + 1)) {
+				iz = hechos.cima();
+				hechos.desapila();
+			}
+			Posicion cierre = _datos->buscaCierre(p);
+			if (_datos->bit(cierre + 1)) {
+				dr = hechos.cima();
+				hechos.desapila();
+			}
+			hechos.apila(A(iz, _datos->_elems[i], dr));
+		}
+		return hechos.cima();
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbinSucinto(const ArbinSucinto &other) : _datos(NULL) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbinSucinto &operator=(const ArbinSucinto &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	/**
+	 Secuencia de parntesis, elementos e ndices de un
+	 rbol, compartidos por sus copias.
+	 */
+	class Datos {
+	public:
+		Datos() : _bits(NULL), _numBits(0), _elems(NULL), _numNodos(0),
+			_rangos(NULL), _minimos(NULL), _numBloques(0), _hojas(0),
+			_numRefs(0) {}
+
+		~Datos() {
+			delete []_bits;
+			delete []_elems;
+			delete []_rangos;
+			delete []_minimos;
+		}
+
+		bool bit(Posicion p) const {
+			return (_bits[p / 64] >> (p % 64)) & 1;
+		}
+
+		/** Nmero de unos en las posiciones [0, k). */
+		Posicion rango(Posicion k) const {
+			Posicion ret = _rangos[k / BITS_BLOQUE];
+			for (Posicion w = (k / BITS_BLOQUE) * (BITS_BLOQUE / 64); w < k / 64; ++w)
+				ret += cuentaUnos(_bits[w]);
+			if (k % 64 != 0)
+				ret += cuentaUnos(_bits[k / 64] & ((1ULL << (k % 64)) - 1));
+			return ret;
+		}
+
+		/** Exceso E(k) de las posiciones [0, k). */
+		long long exceso(Posicion k) const {
+			return 2 * (long long) rango(k) - (long long) k;
+		}
+
+		/** Posicin del parntesis que cierra el abierto en p. */
+		Posicion buscaCierre(Posicion p) const {
+			return buscaAdelante(p, exceso(p)) - 1;
+		}
+
+		/** Posicin del parntesis que abre el cerrado en c. */
+		Posicion buscaApertura(Posicion c) const {
+			return buscaAtras(c, exceso(c + 1));
+		}
+
+		/**
+		 Primera k > k0 con E(k) = objetivo, siendo
+		 E(k0) > objetivo. Como E cambia de uno en uno,
+		 es tambin la primera k con E(k) <= objetivo.
+		 */
+		Posicion buscaAdelante(Posicion k0, long long objetivo) const {
+			Posicion b = k0 / BITS_BLOQUE;
+			Posicion k = recorreAdelante(k0, exceso(k0), finBloque(b), objetivo);
+			if (k != NINGUNA)
+				return k;
+
+			b = siguienteBloque(b, objetivo);
+			if (b == NINGUNA)
+				return NINGUNA;
+			k = b * BITS_BLOQUE;
+			long long e = exceso(k);
+			if (e == objetivo)
+				return k;
+			return recorreAdelante(k, e, finBloque(b), objetivo);
+		}
+
+		/**
+		 ltima k < k0 con E(k) = objetivo, siendo
+		 E(k0) > objetivo.
+		 */
+		Posicion buscaAtras(Posicion k0, long long objetivo) const {
+			Posicion b = k0 / BITS_BLOQUE;
+			Posicion k = recorreAtras(k0, exceso(k0), b * BITS_BLOQUE, objetivo);
+			if (k != NINGUNA)
+				return k;
+
+			b = anteriorBloque(b, objetivo);
+			if (b == NINGUNA)
+				return NINGUNA;
+			k = finBloque(b);
+			long long e = exceso(k);
+			if (e == objetivo)
+				return k;
+			return recorreAtras(k, e, b * BITS_BLOQUE, objetivo);
+		}
+
+		/**
+		 Calcula los rangos por bloque y el rbol de mnimos
+		 una vez escrita la secuencia. El bloque b abarca los
+		 excesos E(k) con k en [b BITS_BLOQUE, (b + 1) BITS_BLOQUE),
+		 sin pasar de _numBits.
+		 */
+		void construyeIndices() {
+			_numBloques = _numBits / BITS_BLOQUE + 1;
+			_rangos = new Posicion[_numBloques];
+			_hojas = 1;
+			while (_hojas < _numBloques)
+				_hojas *= 2;
+			_minimos = new long long[2 * _hojas];
+
+			Posicion unos = 0;
+			long long e = 0;
+			for (Posicion b = 0; b < _numBloques; ++b) {
+				_rangos[b] = unos;
+				long long minimo = e;
+				Posicion fin = finBloque(b);
+				// Se recorren todos los bits del bloque, pero el
+				// exceso tras el ltimo ya es el primero del
+				// bloque siguiente
+				Posicion finBits = (b + 1) * BITS_BLOQUE;
+				if (finBits > _numBits)
+					finBits = _numBits;
+				for (Posicion k = b * BITS_BLOQUE; k < finBits; ++k) {
+					if (bit(k)) {
+						++unos;
+						++e;
+					} else
+						--e;
+					if ((k + 1 <= fin) && (e < minimo))
+						minimo = e;
+				}
+				_minimos[_hojas + b] = minimo;
+			}
+			for (Posicion b = _numBloques; b < _hojas; ++b)
+				_minimos[_hojas + b] = SIN_MINIMO;
+			for (Posicion i = _hojas - 1; i > 0; --i)
+				_minimos[i] = _minimos[2 * i] < _minimos[2 * i + 1] ?
+					_minimos[2 * i] : _minimos[2 * i + 1];
+		}
+
+		unsigned long long *_bits;
+		Posicion _numBits;
+
+		/** Elementos, en preorden. */
+		T *_elems;
+		Posicion _numNodos;
+
+		/** Unos antes del comienzo de cada bloque. */
+		Posicion *_rangos;
+
+		/**
+		 rbol de mnimos del exceso por bloques, como un
+		 montculo: la raz en 1 y los bloques en las hojas,
+		 desde _hojas.
+		 */
+		long long *_minimos;
+		Posicion _numBloques;
+		Posicion _hojas;
+
+		int _numRefs;
+
+	private:
+		Datos(const Datos &);
+		Datos &operator=(const Datos &);
+
+		/** Mnimo de los bloques de relleno del rbol. */
+		static const long long SIN_MINIMO = 0x7fffffffffffffffLL;
+
+		static unsigned int cuentaUnos(unsigned long long x) {
+#ifdef _MSC_VER
+			return (unsigned int) __popcnt64(x);
+#else
+			return __builtin_popcountll(x);
+#endif
+		}
+
+		/** ltima k del bloque b (incluida). */
+		Posicion finBloque(Posicion b) const {
+			Posicion fin = (b + 1) * BITS_BLOQUE - 1;
+			return fin < _numBits ? fin : _numBits;
+		}
+
+		/**
+		 Tablas por byte para recorrer los bits de 8 en 8:
+		 lo que cambia el exceso al pasar el byte (bits del
+		 menos al ms significativo), el mnimo de los excesos
+		 intermedios al avanzar, y el mnimo al retroceder
+		 desde el final del byte.
+		 */
+		struct TablasByte {
+			TablasByte() {
+				for (int v = 0; v < 256; ++v) {
+					int e = 0, minimo = 8;
+					for (int i = 0; i < 8; ++i) {
+						e += ((v >> i) & 1) ? 1 : -1;
+						if (e < minimo) minimo = e;
+					}
+					_cambio[v] = (signed char) e;
+					_minAdelante[v] = (signed char) minimo;
+					e = 0;
+					minimo = 8;
+					for (int i = 7; i >= 0; --i) {
+						e -= ((v >> i) & 1) ? 1 : -1;
+						if (e < minimo) minimo = e;
+					}
+					_minAtras[v] = (signed char) minimo;
+				}
+			}
+			signed char _cambio[256];
+			signed char _minAdelante[256];
+			signed char _minAtras[256];
+		};
+
+		static const TablasByte &tablas() {
+			static const TablasByte t;
+			return t;
+		}
+
+		unsigned int byte(Posicion k) const {
+			return (unsigned int)(_bits[k / 64] >> (k % 64)) & 0xff;
+		}
+
+		/**
+		 Avanza desde k0 (con exceso e) hasta fin como mucho,
+		 buscando la primera k > k0 con E(k) = objetivo.
+		 */
+		Posicion recorreAdelante(Posicion k0, long long e, Posicion fin,
+		                         long long objetivo) const {
+			const TablasByte &t = tablas();
+			Posicion k = k0;
+			while (k < fin) {
+				if ((k % 8 == 0) && (k + 8 <= fin) &&
+					(e + t._minAdelante[byte(k)] > objetivo)) {
+					e += t._cambio[byte(k)];
+					k += 8;
+					continue;
+				}
+				e += bit(k) ? 1 : -1;
+				++k;
+				if (e == objetivo)
+					return k;
+			}
+			return NINGUNA;
+		}
+
+		/**
+		 Retrocede desde k0 (con exceso e) hasta ini como
+		 mucho, buscando la ltima k < k0 con E(k) = objetivo.
+		 */
+		Posicion recorreAtras(Posicion k0, long long e, Posicion ini,
+		                      long long objetivo) const {
+			const TablasByte &t = tablas();
+			Posicion k = k0;
+			while (k > ini) {
+				if ((k % 8 == 0) && (k - 8 >= ini) &&
+					(e + t._minAtras[byte(k - 8)] > objetivo)) {
+					e -= t._cambio[byte(k - 8)];
+					k -= 8;
+					continue;
+				}
+				--k;
+				e -= bit(k) ? 1 : -1;
+				if (e == objetivo)
+					return k;
+			}
+			return NINGUNA;
+		}
+
+		/** Primer bloque > b cuyo mnimo es <= objetivo. */
+		Posicion siguienteBloque(Posicion b, long long objetivo) const {
+			Posicion i = _hojas + b;
+			while (i > 1) {
+				if ((i % 2 == 0) && (_minimos[i + 1] <= objetivo)) {
+					i = i + 1;
+					while (i < _hojas) {
+						i = 2 * i;
+						if (_minimos[i] > objetivo)
+							++i;
+					}
+					return i - _hojas;
+				}
+				i /= 2;
+			}
+			return NINGUNA;
+		}
+
+		/** ltimo bloque < b cuyo mnimo es <= objetivo. */
+		Posicion anteriorBloque(Posicion b, long long objetivo) const {
+			Posicion i = _hojas + b;
+			while (i > 1) {
+				if ((i % 2 == 1) && (_minimos[i - 1] <= objetivo)) {
+					i = i - 1;
+					while (i < _hojas) {
+						i = 2 * i + 1;
+						if (_minimos[i] > objetivo)
+							--i;
+					}
+					return i - _hojas;
+				}
+				i /= 2;
+			}
+			return NINGUNA;
+		}
+	};
+
+public:
+
+	/** Posicin que no corresponde a ningn nodo. */
+	static const Posicion NINGUNA = ~0ULL;
+
+	/**
+	 Vista de un nodo del rbol (o de un rbol vaco), con
+	 las observadoras de Arbin::Vista y adems padre y
+	 numNodos. Es slo una posicin: como Arbin::Vista, no
+	 mantiene vivos los datos, y es vlida mientras exista
+	 algn ArbinSucinto que los comparta.
+	 */
+	class Vista {
+	public:
+		/** Vista del rbol vaco. */
+		Vista() : _datos(NULL), _pos(NINGUNA) {}
+
+		/** Elemento de la raz; error si la vista es vaca. */
+		const T &raiz() const {
+			if (esVacio())
+				throw EArbolVacio();
+			// La raz ficticia es el primer uno
+			return _datos->_elems[_datos->rango(_pos) - 1];
+		}
+
+		/** Vista del hijo izquierdo (primer hijo); O(1). */
+		Vista iz() const {
+			if (esVacio())
+				throw EArbolVacio();
+			return vistaSiAbre(_pos + 1);
+		}
+
+		/** Vista del hijo derecho (siguiente hermano). */
+		Vista dr() const {
+			if (esVacio())
+				throw EArbolVacio();
+			return vistaSiAbre(_datos->buscaCierre(_pos) + 1);
+		}
+
+		/**
+		 Vista del padre: el nodo anterior si ste es su
+		 primer hijo (hijo izquierdo) o el hermano anterior
+		 (del que es hijo derecho). Vaca para la raz.
+		 */
+		Vista padre() const {
+			if (esVacio())
+				throw EArbolVacio();
+			if (_datos->bit(_pos - 1))
+				return _pos - 1 == 0 ? Vista() : Vista(_datos, _pos - 1);
+			return Vista(_datos, _datos->buscaApertura(_pos - 1));
+		}
+
+		/**
+		 Nmero de nodos del subrbol: el nodo, sus hijos en
+		 el bosque y sus hermanos siguientes, que ocupan hasta
+		 el parntesis que cierra a su padre en el bosque.
+		 */
+		Posicion numNodos() const {
+			if (esVacio())
+				return 0;
+			Posicion cierrePadre =
+				_datos->buscaAdelante(_pos, _datos->exceso(_pos) - 1) - 1;
+			return (cierrePadre - _pos) / 2;
+		}
+
+		bool esVacio() const {
+			return _pos == NINGUNA;
+		}
+
+		/** Posicin del nodo en la secuencia de parntesis. */
+		Posicion posicion() const {
+			return _pos;
+		}
+
+	protected:
+		friend class ArbinSucinto;
+
+		Vista(const Datos *datos, Posicion pos) : _datos(datos), _pos(pos) {}
+
+		Vista vistaSiAbre(Posicion p) const {
+			if ((p < _datos->_numBits) && _datos->bit(p))
+				return Vista(_datos, p);
+			return Vista();
+		}
+
+		const Datos *_datos;
+		Posicion _pos;
+	};
+
+protected:
+
+	/**
+	 Va escribiendo la secuencia de parntesis y los
+	 elementos en vectores que crecen al doble cuando se
+	 llenan, y al terminar los recorta y calcula los
+	 ndices.
+	 */
+	class Constructor {
+	public:
+		Constructor() : _datos(new Datos()), _tamBits(0), _tamElems(0) {
+			escribe(true); // Raz ficticia
+		}
+
+		~Constructor() {
+			delete _datos;
+		}
+
+		void abre(const T &elem) {
+			escribe(true);
+			if (_datos->_numNodos == _tamElems)
+				amplia(_datos->_elems, _datos->_numNodos, _tamElems);
+			_datos->_elems[_datos->_numNodos++] = elem;
+		}
+
+		void cierra() {
+			escribe(false);
+		}
+
+		/**
+		 Cierra la raz ficticia y devuelve los datos (NULL
+		 si el rbol es vaco).
+		 */
+		Datos *termina() {
+			escribe(false);
+			Datos *ret = _datos;
+			_datos = NULL;
+			if (ret->_numNodos == 0) {
+				delete ret;
+				return NULL;
+			}
+
+			Posicion palabras = (ret->_numBits + 63) / 64;
+			recorta(ret->_bits, palabras);
+			recorta(ret->_elems, ret->_numNodos);
+			ret->construyeIndices();
+			ret->_numRefs = 1;
+			return ret;
+		}
+
+	private:
+		void escribe(bool abre) {
+			Posicion p = _datos->_numBits;
+			if (p / 64 == _tamBits) {
+				Posicion usadas = _tamBits;
+				amplia(_datos->_bits, usadas, _tamBits);
+				for (Posicion i = usadas; i < _tamBits; ++i)
+					_datos->_bits[i] = 0;
+			}
+			if (abre)
+				_datos->_bits[p / 64] |= 1ULL << (p % 64);
+			_datos->_numBits++;
+		}
+
+		template <class E>
+		static void amplia(E *&v, Posicion usados, Posicion &tam) {
+			Posicion nuevoTam = tam == 0 ? 16 : 2 * tam;
+			E *nuevo = new E[nuevoTam];
+			for (Posicion i = 0; i < usados; ++i)
+				nuevo[i] = v[i];
+			delete []v;
+			v = nuevo;
+			tam = nuevoTam;
+		}
+
+		template <class E>
+		static void recorta(E *&v, Posicion tam) {
+			E *nuevo = new E[tam];
+			for (Posicion i = 0; i < tam; ++i)
+				nuevo[i] = v[i];
+			delete []v;
+			v = nuevo;
+		}
+
+		Datos *_datos;
+		Posicion _tamBits;
+		Posicion _tamElems;
+	};
+
+	void libera() {
+		if ((_datos != NULL) && (--_datos->_numRefs == 0))
+			delete _datos;
+		_datos = NULL;
+	}
+
+	void copia(const ArbinSucinto &other) {
+		_datos = other._datos;
+		if (_datos != NULL)
+			_datos->_numRefs++;
+	}
+
+	/** Datos compartidos; NULL en el rbol vaco. */
+	Datos *_datos;
+};
+
+#endif // __ARBINSUCINTO_H
@@ -18,6 +18,17 @@
 
 #include "Pila.h" // Usado internamente por los iteradores
 
+#include "Arena.h" // Nodos reservados en bloques contiguos
+
+#include "ArbusCongelado.h" // Resultado de congela
+
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <exception> // Excepciones de los hilos de desdeOrdenado
+#include <iterator> // std::distance y std::advance en desdeOrdenado
+#include <thread> // Construccin paralela en desdeOrdenado
+#include <type_traits> // Nodos sin destructor en libera
+
 /**
  Implementacin dinmica del TAD Arbus utilizando 
  nodos con un puntero al hijo izquierdo y otro al
@@ -72,14 +83,36 @@ private:
 
 public:
 
+	/**
+	 Forma de reservar los nodos del rbol:
+
+	 - NODOS_SUELTOS: cada nodo se reserva y se libera
+	   por separado con new y delete.
+	 - NODOS_EN_ARENA: los nodos se reservan en bloques
+	   contiguos de una Arena y los borrados se reutilizan.
+	   Destruir el rbol cuesta O(nmero de bloques) si ni
+	   la clave ni el valor necesitan destructor.
+	 */
+	enum Asignacion { NODOS_SUELTOS, NODOS_EN_ARENA };
+
 	/** Constructor; operacion ArbolVacio */
-	Arbus() : _ra(NULL) {
+	Arbus() : _ra(NULL), _ultimo(NULL), _usaArena(false), _arena(NULL) {
+	}
+
+	/**
+	 Constructor; operacion ArbolVacio indicando cmo se
+	 reservan los nodos.
+	 */
+	explicit Arbus(Asignacion asignacion) :
+		_ra(NULL), _ultimo(NULL), _usaArena(asignacion == NODOS_EN_ARENA),
+		_arena(NULL) {
 	}
 
 	/** Destructor; elimina la estructura jerrquica de nodos. */
 	~Arbus() {
 		libera();
 		_ra = NULL;
+		delete _arena;
 	}
 
 	/**
@@ -89,9 +122,19 @@ public:
 	 @param valor Valor asociado a esa clave. Si la clave
 	 ya se haba insertado previamente, sustituimos el valor
 	 viejo por el nuevo.
+
+	 Si la clave es mayor que todas las del rbol se cuelga
+	 directamente del ltimo nodo, sin bajar desde la raz,
+	 por lo que aadir una secuencia ordenada de claves cuesta
+	 O(1) por clave (aunque el rbol resultante, como en
+	 cualquier insercin ordenada, degenera en una lista).
 	 */
 	void inserta(const Clave &clave, const Valor &valor) {
-		_ra = insertaAux(clave, valor, _ra);
+		Nodo *ult = ultimo();
+		if ((ult == NULL) || (ult->_clave < clave))
+			anadeAlFinal(clave, valor);
+		else
+			_ra = insertaAux(clave, valor, _ra);
 	}
 
 	/**
@@ -106,6 +149,8 @@ public:
 	 @param clave Clave a eliminar.
 	 */
 	void borra(const Clave &clave) {
+		if ((_ultimo != NULL) && (_ultimo->_clave == clave))
+			_ultimo = NULL;
 		_ra = borraAux(_ra, clave);
 	}
 
@@ -119,7 +164,7 @@ public:
 
 	 @param clave Clave por la que se pregunta.
 	 */
-	const Valor &consulta(const Clave &clave) {
+	const Valor &consulta(const Clave &clave) const {
 		Nodo *p = buscaAux(_ra, clave);
 		if (p == NULL)
 			throw EClaveErronea();
@@ -137,7 +182,7 @@ public:
 
 	 @param clave Clave por la que se pregunta.
 	 */
-	bool esta(const Clave &clave) {
+	bool esta(const Clave &clave) const {
 		return buscaAux(_ra, clave) != NULL;
 	}
 
@@ -152,6 +197,97 @@ public:
 		return _ra == NULL;
 	}
 
+	// //
+	// CONSTRUCCIN A PARTIR DE DATOS ORDENADOS
+	// //
+
+	/**
+	 Tamao mnimo de rango a partir del cual merece la
+	 pena lanzar un hilo en la construccin paralela.
+	 */
+	enum { UMBRAL_PARALELO = 1 << 14 };
+
+	/**
+	 Construye un rbol de bsqueda perfectamente equilibrado
+	 a partir de una secuencia de parejas (first = clave,
+	 second = valor) ordenada por clave y sin claves repetidas,
+	 como la que queda tras un std::sort. Insertar esa secuencia
+	 con inserta degenerara el rbol en una lista; aqu, en
+	 cambio, el coste es lineal y todos los nodos se reservan
+	 de una sola vez en un nico bloque de la arena del rbol,
+	 en inorden. El rbol resultante usa NODOS_EN_ARENA.
+
+	 @param ini Iterador al comienzo de la secuencia.
+	 @param fin Iterador al final de la secuencia.
+	 @param paralelo Si es true, las dos mitades de cada
+	 subrbol grande se construyen en hilos distintos. En ese
+	 modo conviene que los iteradores sean de acceso aleatorio,
+	 pues cada hilo salta directamente a la mitad de su rango.
+	 @return rbol con todas las parejas de la secuencia. Se
+	 devuelve por movimiento, as que asignarlo a un rbol
+	 existente no copia los nodos fuera del bloque.
+	 */
+	template <class It>
+	static Arbus desdeOrdenado(It ini, It fin, bool paralelo = false) {
+		std::size_t n = std::distance(ini, fin);
+		if (n == 0)
+			return Arbus();
+
+		Arena<Nodo> arena;
+		Nodo *bloque = arena.reservaContiguos(n);
+		Nodo *raiz;
+		if (paralelo) {
+			unsigned int hilos = std::thread::hardware_concurrency();
+			raiz = construyeParalelo(bloque, 0, n, ini,
+									 hilos > 0 ? hilos : 2);
+		} else
+			raiz = construyeAux(bloque, 0, n, ini);
+
+		return Arbus(raiz, arena);
+	}
+
+	/**
+	 Recoloca todos los nodos del rbol en una arena nueva
+	 siguiendo el inorden, sin cambiar la forma del rbol.
+	 Tras muchas inserciones y borrados los nodos quedan
+	 dispersos; despus de compactar, claves consecutivas
+	 quedan en posiciones de memoria consecutivas (varias
+	 por lnea de cach), lo que acelera los recorridos.
+	 El rbol pasa a usar NODOS_EN_ARENA. O(n).
+	 */
+	void compacta() {
+		Arbus compactado(NODOS_EN_ARENA);
+		compactado.copia(*this);
+
+		Nodo *ra = _ra;
+		_ra = compactado._ra;
+		compactado._ra = ra;
+		_ultimo = NULL;
+		bool usaArena = _usaArena;
+		_usaArena = true;
+		compactado._usaArena = usaArena;
+		Arena<Nodo> *arena = _arena;
+		_arena = compactado._arena;
+		compactado._arena = arena;
+	}
+
+	/**
+	 Construye una copia de slo lectura del rbol en la
+	 que las bsquedas son mucho ms rpidas (ver
+	 ArbusCongelado.h): las claves quedan en un vector con la
+	 disposicin de Eytzinger y se buscan sin saltos
+	 condicionales ni punteros. Conviene cuando, una vez
+	 construido, el diccionario slo se va a consultar. El
+	 rbol no se modifica. O(n).
+	 @return Diccionario inmutable con las mismas parejas.
+	 */
+	ArbusCongelado<Clave, Valor> congela() const {
+		std::size_t n = 0;
+		for (Iterador it(_ra); it != final(); it.avanza())
+			++n;
+		return ArbusCongelado<Clave, Valor>(Iterador(_ra), n);
+	}
+
 	// //
 	// OPERACIONES RELACIONADAS CON LOS ITERADORES
 	// //
@@ -182,6 +318,11 @@ public:
 					_ascendientes.desapila();
 				}
 			}
+
+			// Si es un iterador de rango y hemos llegado
+			// al lmite superior, el recorrido termina
+			if (_act == _fin)
+				_act = NULL;
 		}
 
 		const Clave &clave() const {
@@ -206,11 +347,41 @@ public:
 		// tipo iterador
 		friend class Arbus;
 
-		Iterador() : _act(NULL) {}
-		Iterador(Nodo *act) {
+		Iterador() : _act(NULL), _fin(NULL) {}
+		Iterador(Nodo *act) : _fin(NULL) {
 			_act = primeroInOrden(act);
 		}
 
+		/**
+		 Coloca el iterador en el primer nodo (en inorden)
+		 de la estructura que comienza en p cuya clave es
+		 mayor o igual que la dada (o estrictamente mayor si
+		 estricto es true). Como en primeroInOrden, se apilan
+		 los ascendientes an por visitar: son exactamente
+		 aquellos en los que descendemos por la izquierda.
+		 @param p Puntero a la raz de la estructura.
+		 @param clave Clave a partir de la que buscar.
+		 @param estricto Si es true, se salta la propia clave.
+		 */
+		void colocaEn(Nodo *p, const Clave &clave, bool estricto) {
+			_act = NULL;
+			while (p != NULL) {
+				if (!estricto && (p->_clave == clave)) {
+					_act = p;
+					return;
+				} else if (clave < p->_clave) {
+					_ascendientes.apila(p);
+					p = p->_iz;
+				} else
+					p = p->_dr;
+			}
+
+			if (!_ascendientes.esVacia()) {
+				_act = _ascendientes.cima();
+				_ascendientes.desapila();
+			}
+		}
+
 		/**
 		 Busca el primer elemento en inorden de
 		 la estructura jerrquica de nodos pasada
@@ -236,6 +407,11 @@ public:
 		// Ascendientes del nodo actual
 		// an por visitar
 		Pila<Nodo*> _ascendientes;
+
+		// Nodo en el que termina el recorrido (excluido)
+		// en los iteradores de rango; NULL si el recorrido
+		// llega hasta el final del rbol.
+		Nodo *_fin;
 	};
 	
 	/**
@@ -255,6 +431,129 @@ public:
 		return Iterador(NULL);
 	}
 
+	/**
+	 Devuelve un iterador a la primera clave del rbol
+	 que es mayor o igual que la dada (cota inferior).
+	 El coste es O(log n) en un rbol equilibrado; avanzar
+	 desde l las k claves siguientes cuesta O(k).
+	 @param clave Clave desde la que empezar el recorrido.
+	 @return Iterador a la primera clave >= clave; final()
+	 si no hay ninguna.
+	 */
+	Iterador buscaDesde(const Clave &clave) const {
+		Iterador ret;
+		ret.colocaEn(_ra, clave, false);
+		return ret;
+	}
+
+	/**
+	 Devuelve un iterador a la primera clave del rbol
+	 que es estrictamente mayor que la dada (cota superior).
+	 @param clave Clave tras la que empezar el recorrido.
+	 @return Iterador a la primera clave > clave; final()
+	 si no hay ninguna.
+	 */
+	Iterador buscaDespues(const Clave &clave) const {
+		Iterador ret;
+		ret.colocaEn(_ra, clave, true);
+		return ret;
+	}
+
+	/**
+	 Devuelve un iterador que recorre en orden las claves
+	 del intervalo [desde, hasta). El iterador llega a
+	 final() al alcanzar la primera clave >= hasta, por lo
+	 que se recorre igual que el iterador completo:
+
+	   for (it = a.rango(d, h); it != a.final(); it.avanza())
+
+	 Una consulta por prefijo sobre claves de tipo string
+	 (por ejemplo los telfonos normalizados "XXX-XXXX")
+	 es el rango [prefijo, prefijo + '\xff').
+	 @param desde Primera clave del rango (incluida).
+	 @param hasta Clave lmite del rango (excluida).
+	 @return Iterador al comienzo del rango; final() si
+	 el rango es vaco.
+	 */
+	Iterador rango(const Clave &desde, const Clave &hasta) const {
+		if (!(desde < hasta))
+			return final();
+
+		Iterador ret;
+		ret.colocaEn(_ra, desde, false);
+		ret._fin = buscaDesde(hasta)._act;
+		if (ret._act == ret._fin)
+			ret._act = NULL;
+		return ret;
+	}
+
+	/**
+	 Inserta una clave/valor usando como pista un iterador
+	 al elemento que quedar justo antes de ella (por ejemplo,
+	 el devuelto por la insercin anterior al aadir claves
+	 casi ordenadas). Los ascendientes que guarda el iterador
+	 acotan por arriba las claves que caben tras la pista, as
+	 que se comprueba en O(1) si la pista es buena:
+
+	   - Si lo es y la pista no tiene hijo derecho, el nodo
+	     nuevo se cuelga ah mismo, sin bajar desde la raz.
+	   - Si lo es y tiene hijo derecho, se inserta en ese
+	     subrbol, que es el nico que puede contener la clave.
+	   - Si no lo es (o es final()), se inserta desde la raz
+	     como en inserta(clave, valor).
+
+	 Las claves mayores que todas las del rbol se aaden
+	 al final en O(1) sea cual sea la pista.
+
+	 La propia pista pasa a apuntar a la clave insertada, sin
+	 copiar su pila de ascendientes: con una pista buena sin
+	 hijo derecho la pila no cambia, y el coste es O(1). Al
+	 aadir al final o con una pista mala hay que vaciarla,
+	 pero cada ascendiente que se desapila se apil antes, as
+	 que usando siempre el mismo iterador el coste amortizado
+	 sigue siendo el de las inserciones.
+	 @param pista Iterador al elemento anterior a la clave;
+	 al terminar apunta a la clave insertada y sirve de pista
+	 para la siguiente.
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave (sustituye al
+	 anterior si la clave ya estaba).
+	 @return La propia pista.
+	 */
+	Iterador &inserta(Iterador &pista, const Clave &clave, const Valor &valor) {
+		pista._fin = NULL;
+		Nodo *ult = ultimo();
+		if ((ult == NULL) || (ult->_clave < clave)) {
+			// El ltimo nodo no tiene ascendientes por visitar
+			vaciaAscendientes(pista);
+			pista._act = anadeAlFinal(clave, valor);
+			return pista;
+		}
+
+		Nodo *p = pista._act;
+		if ((p == NULL) || (clave < p->_clave) ||
+			(!pista._ascendientes.esVacia() &&
+			 !(clave < pista._ascendientes.cima()->_clave))) {
+			_ra = insertaAux(clave, valor, _ra);
+			vaciaAscendientes(pista);
+			pista.colocaEn(_ra, clave, false);
+			return pista;
+		}
+
+		if (p->_clave == clave) {
+			p->_valor = valor;
+		} else if (p->_dr == NULL) {
+			// Los ascendientes por visitar del hijo derecho
+			// son los mismos que los de la pista
+			p->_dr = nuevoNodo(clave, valor);
+			pista._act = p->_dr;
+		} else {
+			p->_dr = insertaAux(clave, valor, p->_dr);
+			pista.colocaEn(p->_dr, clave, false);
+		}
+		return pista;
+	}
+
 
 	// //
 	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
@@ -262,19 +561,52 @@ public:
 	// //
 
 	/** Constructor copia */
-	Arbus(const Arbus<Clave, Valor> &other) : _ra(NULL) {
+	Arbus(const Arbus<Clave, Valor> &other) :
+		_ra(NULL), _ultimo(NULL), _usaArena(other._usaArena), _arena(NULL) {
 		copia(other);
 	}
 
-	/** Operador de asignacin */
+	/**
+	 Operador de asignacin. Como el constructor copia, el
+	 rbol pasa a reservar los nodos igual que other.
+	 */
 	Arbus<Clave, Valor> &operator=(const Arbus<Clave, Valor> &other) {
 		if (this != &other) {
 			libera();
+			_usaArena = other._usaArena;
 			copia(other);
 		}
 		return *this;
 	}
 
+	/**
+	 Constructor por movimiento; se queda con los nodos (y
+	 la arena) de other, que pasa a ser vaco. O(1).
+	 */
+	Arbus(Arbus<Clave, Valor> &&other) :
+		_ra(other._ra), _ultimo(other._ultimo), _usaArena(other._usaArena),
+		_arena(other._arena) {
+		other._ra = NULL;
+		other._ultimo = NULL;
+		other._arena = NULL;
+	}
+
+	/** Operador de asignacin por movimiento. O(1). */
+	Arbus<Clave, Valor> &operator=(Arbus<Clave, Valor> &&other) {
+		if (this != &other) {
+			libera();
+			_ra = other._ra;
+			_ultimo = other._ultimo;
+			_usaArena = other._usaArena;
+			Arena<Nodo> *arena = _arena;
+			_arena = other._arena;
+			other._arena = arena;
+			other._ra = NULL;
+			other._ultimo = NULL;
+		}
+		return *this;
+	}
+
 protected:
 
 	/**
@@ -283,15 +615,36 @@ protected:
 	 previamente creada.
 	 Se utiliza en hijoIz e hijoDr.
 	 */
-	Arbus(Nodo *raiz) : _ra(raiz) {
+	Arbus(Nodo *raiz) : _ra(raiz), _ultimo(NULL), _usaArena(false), _arena(NULL) {
+	}
+
+	/**
+	 Constructor protegido que crea un rbol a partir de
+	 una estructura jerrquica de nodos reservados en una
+	 arena, de la que pasa a ser dueo (la arena recibida
+	 queda vaca).
+	 Se utiliza en desdeOrdenado.
+	 */
+	Arbus(Nodo *raiz, Arena<Nodo> &arena) :
+		_ra(raiz), _ultimo(NULL), _usaArena(true), _arena(NULL) {
+		this->arena().intercambia(arena);
 	}
 
 	void libera() {
-		libera(_ra);
+		if (_usaArena) {
+			// Si los nodos no tienen destructor que llamar,
+			// basta con devolver los bloques de la arena
+			if (!std::is_trivially_destructible<Nodo>::value)
+				destruye(_ra);
+			if (_arena != NULL)
+				_arena->liberaTodo();
+		} else
+			libera(_ra);
 	}
 
 	void copia(const Arbus &other) {
 		_ra = copiaAux(other._ra);
+		_ultimo = NULL;
 	}
 
 private:
@@ -301,28 +654,115 @@ private:
 	 que comienza con el puntero ra.
 	 Se admite que el nodo sea NULL (no habr nada que
 	 liberar).
+
+	 No es recursivo ni usa pila: mientras la raz tenga
+	 hijo izquierdo se rota a la derecha (el hijo sube); cuando
+	 no lo tiene se libera y se sigue por su hijo derecho. As
+	 el coste es O(n) y la memoria adicional O(1) incluso en
+	 rboles degenerados, que con la versin recursiva
+	 desbordaban la pila del programa.
+	 */
+	void libera(Nodo *ra) {
+		while (ra != NULL) {
+			if (ra->_iz != NULL) {
+				Nodo *iz = ra->_iz;
+				ra->_iz = iz->_dr;
+				iz->_dr = ra;
+				ra = iz;
+			} else {
+				Nodo *dr = ra->_dr;
+				liberaNodo(ra);
+				ra = dr;
+			}
+		}
+	}
+
+	/**
+	 Llama al destructor de todos los nodos de la estructura
+	 que comienza en ra, sin devolverlos a la arena (que se
+	 va a liberar entera a continuacin). Recorre el rbol
+	 igual que libera.
 	 */
-	static void libera(Nodo *ra) {
-		if (ra != NULL) {
-			libera(ra->_iz);
-			libera(ra->_dr);
-			delete ra;
+	static void destruye(Nodo *ra) {
+		while (ra != NULL) {
+			if (ra->_iz != NULL) {
+				Nodo *iz = ra->_iz;
+				ra->_iz = iz->_dr;
+				iz->_dr = ra;
+				ra = iz;
+			} else {
+				Nodo *dr = ra->_dr;
+				ra->~Nodo();
+				ra = dr;
+			}
 		}
 	}
 
+	/**
+	 Nodo del original pendiente de copiar en copiaAux,
+	 junto con el puntero en el que hay que dejar su copia
+	 (NULL si es un hijo izquierdo).
+	 */
+	struct Pendiente {
+		Pendiente() : _orig(NULL), _destino(NULL) {}
+		Pendiente(Nodo *orig, Nodo **destino) : _orig(orig), _destino(destino) {}
+		Nodo *_orig;
+		Nodo **_destino;
+	};
+
 	/**
 	 Copia la estructura jerrquica de nodos pasada
 	 como parmetro (puntero a su raiz) y devuelve un
 	 puntero a una nueva estructura jerrquica, copia
 	 de anterior (y que, por tanto, habr que liberar).
+	 Si el rbol usa arena, los huecos se reservan en
+	 inorden, para que claves consecutivas queden juntas.
+
+	 El recorrido en inorden se hace con una pila explcita
+	 (de tamao la altura del rbol) en lugar de con
+	 recursin. Cada nodo se copia al visitarlo, cuando la
+	 copia de su hijo izquierdo ya est hecha: esas copias
+	 esperan en la pila izquierdos hasta que su padre las
+	 recoge. La del hijo derecho se deja directamente en el
+	 _dr del padre, que ya existe.
 	 */
-	static Nodo *copiaAux(Nodo *ra) {
-		if (ra == NULL)
-			return NULL;
+	Nodo *copiaAux(Nodo *ra) {
+		Nodo *ret = NULL;
+		Pila<Pendiente> pendientes;
+		Pila<Nodo*> izquierdos;
+
+		Nodo *act = ra;
+		Nodo **destino = &ret;
+		while (true) {
+			while (act != NULL) {
+				pendientes.apila(Pendiente(act, destino));
+				act = act->_iz;
+				destino = NULL;
+			}
+			if (pendientes.esVacia())
+				break;
+
+			Pendiente p = pendientes.cima();
+			pendientes.desapila();
+
+			Nodo *iz = NULL;
+			if (p._orig->_iz != NULL) {
+				iz = izquierdos.cima();
+				izquierdos.desapila();
+			}
+			Nodo *copia = _usaArena ?
+				new (arena().reserva()) Nodo(iz, p._orig->_clave, p._orig->_valor, NULL) :
+				new Nodo(iz, p._orig->_clave, p._orig->_valor, NULL);
+
+			if (p._destino != NULL)
+				*p._destino = copia;
+			else
+				izquierdos.apila(copia);
 
-		return new Nodo(copiaAux(ra->_iz),
-						ra->_clave, ra->_valor,
-						copiaAux(ra->_dr));
+			act = p._orig->_dr;
+			destino = &copia->_dr;
+		}
+		return ret;
 	}
 
 	/**
@@ -340,20 +780,24 @@ private:
 	 @param p Puntero al nodo raz donde insertar la pareja.
 	 @return Nueva raz (o p si no cambia).
 	 */
-	static Nodo *insertaAux(const Clave &clave, const Valor &valor, Nodo *p) {
-
-		if (p == NULL) {
-			return new Nodo(clave, valor);
-		} else if (p->_clave == clave) {
-			p->_valor = valor;
-			return p;
-		} else if (clave < p->_clave) {
-			p->_iz = insertaAux(clave, valor, p->_iz);
-			return p;
-		} else { // (clave > p->_clave)
-			p->_dr = insertaAux(clave, valor, p->_dr);
-			return p;
+	Nodo *insertaAux(const Clave &clave, const Valor &valor, Nodo *p) {
+
+		// Bajamos con un puntero al puntero que habr
+		// que modificar (p, _iz o _dr de algn nodo), de
+		// modo que al llegar a NULL basta con colgar ah
+		// el nodo nuevo, sin deshacer el camino
+		Nodo **ref = &p;
+		while (*ref != NULL) {
+			if ((*ref)->_clave == clave) {
+				(*ref)->_valor = valor;
+				return p;
+			} else if (clave < (*ref)->_clave)
+				ref = &(*ref)->_iz;
+			else // (clave > (*ref)->_clave)
+				ref = &(*ref)->_dr;
 		}
+		*ref = nuevoNodo(clave, valor);
+		return p;
 	}
 
 	/**
@@ -364,16 +808,13 @@ private:
 	 @param clave Clave a buscar
 	 */
 	static Nodo *buscaAux(Nodo *p, const Clave &clave) {
-		if (p == NULL)
-			return NULL;
-
-		if (p->_clave == clave)
-			return p;
-
-		if (clave < p->_clave)
-			return buscaAux(p->_iz, clave);
-		else
-			return buscaAux(p->_dr, clave);
+		while ((p != NULL) && !(p->_clave == clave)) {
+			if (clave < p->_clave)
+				p = p->_iz;
+			else
+				p = p->_dr;
+		}
+		return p;
 	}
 
 	/**
@@ -387,20 +828,22 @@ private:
 	 @return Nueva raz de la estructura, tras el borrado. Si la raz
 	 no cambia, se devuelve el propio p.
 	*/
-	static Nodo *borraAux(Nodo *p, const Clave &clave) {
-
-		if (p == NULL)
-			return NULL;
-
-		if (clave == p->_clave) {
-			return borraRaiz(p);
-		} else if (clave < p->_clave) {
-			p->_iz = borraAux(p->_iz, clave);
-			return p;
-		} else { // clave > p->_clave
-			p->_dr = borraAux(p->_dr, clave);
-			return p;
+	Nodo *borraAux(Nodo *p, const Clave &clave) {
+
+		// Como en insertaAux, ref apunta al puntero que
+		// lleva al nodo actual, que es el que cambia si
+		// ese nodo se borra
+		Nodo **ref = &p;
+		while (*ref != NULL) {
+			if (clave == (*ref)->_clave) {
+				*ref = borraRaiz(*ref);
+				break;
+			} else if (clave < (*ref)->_clave)
+				ref = &(*ref)->_iz;
+			else // clave > (*ref)->_clave
+				ref = &(*ref)->_dr;
 		}
+		return p;
 	}
 
 	/**
@@ -409,7 +852,7 @@ private:
 	 que la estructura sigue siendo vlida para un rbol de
 	 bsqueda (claves ordenadas).
 	 */
-	static Nodo *borraRaiz(Nodo *p) {
+	Nodo *borraRaiz(Nodo *p) {
 
 		Nodo *aux;
 
@@ -417,14 +860,14 @@ private:
 		// el hijo derecho
 		if (p->_iz == NULL) {
 			aux = p->_dr;
-			delete p;
+			liberaNodo(p);
 			return aux;
 		} else
 		// Si no hay hijo derecho, la raz pasa a ser
 		// el hijo izquierdo
 		if (p->_dr == NULL) {
 			aux = p->_iz;
-			delete p;
+			liberaNodo(p);
 			return aux;
 		} else {
 		// Convertimos el elemento ms pequeo del hijo derecho
@@ -445,7 +888,7 @@ private:
 	   - El hijo izquierdo del padre del elemento ms pequeo
 	     pasa a ser el antiguo hijo derecho de ese mnimo.
 	 */
-	static Nodo *mueveMinYBorra(Nodo *p) {
+	Nodo *mueveMinYBorra(Nodo *p) {
 
 		// Vamos bajando hasta que encontramos el elemento
 		// ms pequeo (aquel que no tiene hijo izquierdo).
@@ -473,15 +916,200 @@ private:
 			aux->_iz = p->_iz;
 		}
 
-		delete p;
+		liberaNodo(p);
 		return aux;
 	}
 
+	/**
+	 Devuelve el nodo con la clave ms grande (NULL si el
+	 rbol es vaco). Se guarda en _ultimo y slo se recalcula,
+	 bajando por la derecha, cuando el borrado o la copia lo
+	 han invalidado.
+	 */
+	Nodo *ultimo() {
+		if ((_ultimo == NULL) && (_ra != NULL)) {
+			_ultimo = _ra;
+			while (_ultimo->_dr != NULL)
+				_ultimo = _ultimo->_dr;
+		}
+		return _ultimo;
+	}
+
+	/**
+	 Aade una clave mayor que todas las del rbol como hijo
+	 derecho del ltimo nodo (o como raz si es vaco).
+	 @return El nodo nuevo, que pasa a ser el ltimo.
+	 */
+	Nodo *anadeAlFinal(const Clave &clave, const Valor &valor) {
+		Nodo *nuevo = nuevoNodo(clave, valor);
+		if (_ultimo == NULL)
+			_ra = nuevo;
+		else
+			_ultimo->_dr = nuevo;
+		_ultimo = nuevo;
+		return nuevo;
+	}
+
+	/** Deja vaca la pila de ascendientes de un iterador. */
+	static void vaciaAscendientes(Iterador &it) {
+		while (!it._ascendientes.esVacia())
+			it._ascendientes.desapila();
+	}
+
+	/**
+	 Devuelve la arena del rbol, crendola la primera vez
+	 que se necesita: los rboles con NODOS_SUELTOS (y los
+	 vacos) no pagan por ella.
+	 */
+	Arena<Nodo> &arena() {
+		if (_arena == NULL)
+			_arena = new Arena<Nodo>();
+		return *_arena;
+	}
+
+	/**
+	 Crea un nodo nuevo, en la arena o suelto segn
+	 la forma de reserva del rbol.
+	 */
+	Nodo *nuevoNodo(const Clave &clave, const Valor &valor) {
+		if (_usaArena)
+			return new (arena().reserva()) Nodo(clave, valor);
+		return new Nodo(clave, valor);
+	}
+
+	/**
+	 Libera un nodo de la estructura. Si est en la arena
+	 se destruye y su hueco queda libre para reutilizarlo.
+	 */
+	void liberaNodo(Nodo *p) {
+		if (_usaArena) {
+			p->~Nodo();
+			_arena->devuelve(p);
+		} else
+			delete p;
+	}
+
+	/**
+	 Construye la estructura jerrquica perfectamente
+	 equilibrada con las parejas de las posiciones
+	 [ini, fin) de la entrada, colocndolas en las mismas
+	 posiciones del bloque. La entrada se recorre en inorden,
+	 por lo que el iterador slo necesita avanzar de uno
+	 en uno y el coste total es lineal.
+	 @param bloque Bloque de nodos ya reservado.
+	 @param ini Primera posicin (incluida).
+	 @param fin ltima posicin (excluida).
+	 @param it Iterador a la pareja de la posicin ini; al
+	 terminar apunta a la de la posicin fin.
+	 @return Raz de la estructura construida. Si la copia
+	 de alguna pareja lanza una excepcin, se destruyen los
+	 nodos ya construidos del rango antes de propagarla.
+	 */
+	template <class It>
+	static Nodo *construyeAux(Nodo *bloque, std::size_t ini,
+							  std::size_t fin, It &it) {
+		if (ini == fin)
+			return NULL;
+
+		std::size_t mitad = ini + (fin - ini) / 2;
+		Nodo *iz = construyeAux(bloque, ini, mitad, it);
+		Nodo *p;
+		try {
+			p = new (&bloque[mitad]) Nodo(it->first, it->second);
+		} catch (...) {
+			destruye(iz);
+			throw;
+		}
+		++it;
+		p->_iz = iz;
+		try {
+			p->_dr = construyeAux(bloque, mitad + 1, fin, it);
+		} catch (...) {
+			destruye(p);
+			throw;
+		}
+
+		assert((p->_iz == NULL) || (p->_iz->_clave < p->_clave));
+		return p;
+	}
+
+	/**
+	 Versin paralela de construyeAux: mientras queden
+	 hilos disponibles y el rango sea suficientemente
+	 grande, el hijo izquierdo se construye en un hilo
+	 nuevo y el derecho en el actual. Como los dos rangos
+	 son disjuntos, cada hilo escribe en posiciones distintas
+	 del bloque y no hace falta sincronizacin ms all de
+	 esperar al hilo al terminar. Una excepcin en
+	 cualquiera de los dos hilos se propaga tras esperar
+	 al otro, con los nodos ya construidos del rango
+	 destruidos.
+	 @param it Iterador a la pareja de la posicin ini.
+	 @param hilos Nmero de hilos que se pueden usar para
+	 construir este rango.
+	 */
+	template <class It>
+	static Nodo *construyeParalelo(Nodo *bloque, std::size_t ini,
+								   std::size_t fin, It it, unsigned int hilos) {
+		if ((hilos <= 1) || (fin - ini < UMBRAL_PARALELO))
+			return construyeAux(bloque, ini, fin, it);
+
+		std::size_t mitad = ini + (fin - ini) / 2;
+		It itMitad = it;
+		std::advance(itMitad, mitad - ini);
+		Nodo *p = new (&bloque[mitad]) Nodo(itMitad->first, itMitad->second);
+		++itMitad;
+
+		std::exception_ptr errorIz;
+		std::thread hiloIz;
+		try {
+			hiloIz = std::thread([=, &errorIz]() {
+				try {
+					p->_iz = construyeParalelo(bloque, ini, mitad, it, hilos / 2);
+				} catch (...) {
+					errorIz = std::current_exception();
+				}
+			});
+			p->_dr = construyeParalelo(bloque, mitad + 1, fin, itMitad,
+									   hilos - hilos / 2);
+		} catch (...) {
+			if (hiloIz.joinable())
+				hiloIz.join();
+			destruye(p);
+			throw;
+		}
+		hiloIz.join();
+		if (errorIz) {
+			destruye(p);
+			std::rethrow_exception(errorIz);
+		}
+
+		return p;
+	}
+
 	/** 
 	 Puntero a la raz de la estructura jerrquica
 	 de nodos.
 	 */
 	Nodo *_ra;
+
+	/**
+	 Nodo con la clave ms grande, para aadir al final sin
+	 recorrer el rbol; NULL si hay que recalcularlo.
+	 */
+	Nodo *_ultimo;
+
+	/**
+	 Indica si los nodos se reservan en _arena (true)
+	 o sueltos con new (false).
+	 */
+	bool _usaArena;
+
+	/**
+	 Arena de la que salen los nodos si _usaArena; NULL
+	 hasta que se reserva el primero.
+	 */
+	Arena<Nodo> *_arena;
 };
 
 #endif // __Arbus_H
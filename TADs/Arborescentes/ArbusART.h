@@ -0,0 +1,889 @@
+/**
+  @file ArbusART.h
+
+  Implementacin del TAD Arbol de Bsqueda con claves
+  de tipo string mediante un rbol radix adaptativo
+  (Adaptive Radix Tree, ART).
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSART_H
+#define __ARBUSART_H
+
+#include "Excepciones.h"
+
+#include "Pila.h" // Usado internamente por los iteradores
+
+#include <string>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARBUSART_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ Implementacin del TAD Arbus para claves de tipo
+ std::string (tratadas como secuencias de bytes) mediante
+ un rbol radix adaptativo (Leis, Kemper y Neumann, 2013).
+
+ En lugar de comparar la clave completa en cada nivel,
+ como hace Arbus, cada nivel del rbol consume un byte de
+ la clave y elige el hijo correspondiente. Para no gastar
+ 256 punteros por nodo, los nodos internos se adaptan al
+ nmero de hijos que tienen:
+
+ - Nodo4 y Nodo16: hasta 4 o 16 hijos, con los bytes
+   ordenados en un vector. En Nodo16 la bsqueda compara
+   los 16 bytes a la vez con instrucciones SSE2 (si el
+   compilador las soporta; si no, con un bucle).
+ - Nodo48: un ndice de 256 bytes que indica en cul de
+   sus 48 huecos est el hijo de cada byte.
+ - Nodo256: un puntero por cada byte posible.
+
+ Adems, las cadenas de nodos con un solo hijo se comprimen
+ (path compression): cada nodo interno guarda el prefijo
+ comn de todas las claves que cuelgan de l, que se
+ compara de una vez. Las hojas guardan la clave completa,
+ as que una hoja puede estar a cualquier profundidad y la
+ comparacin final confirma la clave. Una clave que es
+ prefijo de otras (por ejemplo "487" y "487-3279") se guarda
+ en la hoja propia del nodo en el que termina.
+
+ El coste de las operaciones es O(longitud de la clave),
+ independiente del nmero de claves. Los iteradores
+ recorren las claves en el orden de std::string.
+ */
+template <class Valor>
+class ArbusART {
+public:
+	typedef std::string Clave;
+
+private:
+	/** Tipos de nodo del rbol. */
+	enum Tipo { HOJA, NODO4, NODO16, NODO48, NODO256 };
+
+	/** Parte comn a todos los nodos: su tipo. */
+	class Nodo {
+	public:
+		Nodo(Tipo tipo) : _tipo(tipo) {}
+		unsigned char _tipo;
+	};
+
+	/** Hoja: guarda la clave completa y su valor. */
+	class Hoja : public Nodo {
+	public:
+		Hoja(const Clave &clave, const Valor &valor)
+			: Nodo(HOJA), _clave(clave), _valor(valor) {}
+		Clave _clave;
+		Valor _valor;
+	};
+
+	/**
+	 Parte comn a los nodos internos: el prefijo comprimido,
+	 la hoja de la clave que termina en este nodo (si la hay)
+	 y el nmero de hijos.
+	 */
+	class Interno : public Nodo {
+	public:
+		Interno(Tipo tipo) : Nodo(tipo), _hoja(NULL), _numHijos(0) {}
+		std::string _prefijo;
+		Hoja *_hoja;
+		unsigned short _numHijos;
+	};
+
+	class Nodo4 : public Interno {
+	public:
+		Nodo4() : Interno(NODO4) {}
+		unsigned char _claves[4];
+		Nodo *_hijos[4];
+	};
+
+	class Nodo16 : public Interno {
+	public:
+		Nodo16() : Interno(NODO16) {}
+		unsigned char _claves[16];
+		Nodo *_hijos[16];
+	};
+
+	class Nodo48 : public Interno {
+	public:
+		Nodo48() : Interno(NODO48) {
+			std::memset(_indice, 0, sizeof(_indice));
+			std::memset(_hijos, 0, sizeof(_hijos));
+		}
+		// Posicin + 1 del hijo de cada byte (0 si no hay)
+		unsigned char _indice[256];
+		Nodo *_hijos[48];
+	};
+
+	class Nodo256 : public Interno {
+	public:
+		Nodo256() : Interno(NODO256) {
+			std::memset(_hijos, 0, sizeof(_hijos));
+		}
+		Nodo *_hijos[256];
+	};
+
+public:
+
+	/** Constructor; operacion ArbolVacio */
+	ArbusART() : _ra(NULL) {
+	}
+
+	/** Destructor; elimina la estructura jerrquica de nodos. */
+	~ArbusART() {
+		libera();
+		_ra = NULL;
+	}
+
+	/**
+	 Operacin generadora que aade una nueva clave/valor
+	 al rbol.
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave. Si la clave
+	 ya se haba insertado previamente, sustituimos el valor
+	 viejo por el nuevo.
+	 */
+	void inserta(const Clave &clave, const Valor &valor) {
+		insertaAux(&_ra, clave, 0, valor);
+	}
+
+	/**
+	 Operacin modificadora que elimina una clave del rbol.
+	 Si la clave no exista la operacin no tiene efecto.
+	 @param clave Clave a eliminar.
+	 */
+	void borra(const Clave &clave) {
+		borraAux(&_ra, clave, 0);
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada. Es un error preguntar por una clave
+	 que no existe.
+	 @param clave Clave por la que se pregunta.
+	 */
+	const Valor &consulta(const Clave &clave) const {
+		Hoja *h = buscaAux(clave);
+		if (h == NULL)
+			throw EClaveErronea();
+
+		return h->_valor;
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el rbol de bsqueda.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) const {
+		return buscaAux(clave) != NULL;
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _ra == NULL;
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Clase interna que implementa un iterador que
+	 recorre las claves del rbol en orden. Guarda en una
+	 pila los nodos internos del camino hasta la hoja
+	 actual, junto con el siguiente hijo por visitar de
+	 cada uno.
+	 */
+	class Iterador {
+	public:
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+			_act = siguienteHoja();
+		}
+
+		const Clave &clave() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_clave;
+		}
+
+		const Valor &valor() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_valor;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusART;
+
+		/**
+		 Nodo interno del camino y siguiente hijo por visitar
+		 (-1 si falta por visitar su propia hoja).
+		 */
+		struct Marco {
+			Marco() : _nodo(NULL), _pos(-1) {}
+			Marco(Interno *nodo) : _nodo(nodo), _pos(-1) {}
+			Interno *_nodo;
+			int _pos;
+		};
+
+		Iterador() : _act(NULL) {}
+		Iterador(Nodo *raiz) : _act(NULL) {
+			if (raiz == NULL)
+				return;
+			if (raiz->_tipo == HOJA)
+				_act = static_cast<Hoja*>(raiz);
+			else {
+				_pendientes.apila(Marco(static_cast<Interno*>(raiz)));
+				_act = siguienteHoja();
+			}
+		}
+
+		/** Desciende hasta la siguiente hoja en orden. */
+		Hoja *siguienteHoja() {
+			while (!_pendientes.esVacia()) {
+				Marco m = _pendientes.cima();
+				_pendientes.desapila();
+
+				if (m._pos == -1) {
+					m._pos = 0;
+					_pendientes.apila(m);
+					if (m._nodo->_hoja != NULL)
+						return m._nodo->_hoja;
+					continue;
+				}
+
+				Nodo *hijo = hijoEnOrden(m._nodo, m._pos);
+				if (hijo == NULL)
+					continue;
+				m._pos++;
+				_pendientes.apila(m);
+
+				if (hijo->_tipo == HOJA)
+					return static_cast<Hoja*>(hijo);
+				_pendientes.apila(Marco(static_cast<Interno*>(hijo)));
+			}
+			return NULL;
+		}
+
+		// Hoja actual del recorrido; NULL si hemos
+		// llegado al final.
+		Hoja *_act;
+
+		// Nodos internos del camino hasta la hoja actual
+		Pila<Marco> _pendientes;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(_ra);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador();
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbusART(const ArbusART<Valor> &other) : _ra(NULL) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbusART<Valor> &operator=(const ArbusART<Valor> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	void libera() {
+		libera(_ra);
+	}
+
+	void copia(const ArbusART &other) {
+		_ra = copiaAux(other._ra);
+	}
+
+private:
+
+	// //
+	// BSQUEDA DE HIJOS EN LOS DISTINTOS TIPOS DE NODO
+	// //
+
+	/** Posicin del bit a 1 menos significativo (m != 0). */
+	static unsigned int primerBit(unsigned int m) {
+#ifdef _MSC_VER
+		unsigned long pos;
+		_BitScanForward(&pos, m);
+		return pos;
+#else
+		return __builtin_ctz(m);
+#endif
+	}
+
+	/**
+	 Posicin en un Nodo16 del hijo del byte c, o -1 si
+	 no lo tiene. Con SSE2 se comparan los 16 bytes a la vez
+	 y la mscara de coincidencias se limita a los hijos que
+	 realmente hay.
+	 */
+	static int buscaEnNodo16(const Nodo16 *n, unsigned char c) {
+#ifdef ARBUSART_SSE2
+		__m128i iguales = _mm_cmpeq_epi8(_mm_set1_epi8((char)c),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(n->_claves)));
+		unsigned int mascara = _mm_movemask_epi8(iguales) & ((1u << n->_numHijos) - 1);
+		return mascara ? (int)primerBit(mascara) : -1;
+#else
+		for (int i = 0; i < n->_numHijos; ++i)
+			if (n->_claves[i] == c)
+				return i;
+		return -1;
+#endif
+	}
+
+	/**
+	 Posicin en la que habra que insertar el byte c en el
+	 vector ordenado de un Nodo16: la del primer byte mayor.
+	 Las comparaciones SSE2 son con signo, as que se
+	 desplazan los bytes (xor 0x80) para compararlos sin signo.
+	 */
+	static int posicionEnNodo16(const Nodo16 *n, unsigned char c) {
+#ifdef ARBUSART_SSE2
+		const __m128i signo = _mm_set1_epi8((char)0x80);
+		__m128i menores = _mm_cmplt_epi8(
+			_mm_xor_si128(_mm_set1_epi8((char)c), signo),
+			_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(n->_claves)), signo));
+		unsigned int mascara = _mm_movemask_epi8(menores) & ((1u << n->_numHijos) - 1);
+		return mascara ? (int)primerBit(mascara) : n->_numHijos;
+#else
+		int i = 0;
+		while ((i < n->_numHijos) && (n->_claves[i] < c))
+			++i;
+		return i;
+#endif
+	}
+
+	/**
+	 Devuelve un puntero al hueco donde est el hijo del
+	 byte c del nodo interno n, o NULL si no lo tiene.
+	 */
+	static Nodo **buscaHijo(Interno *n, unsigned char c) {
+		switch (n->_tipo) {
+		case NODO4: {
+			Nodo4 *n4 = static_cast<Nodo4*>(n);
+			for (int i = 0; i < n4->_numHijos; ++i)
+				if (n4->_claves[i] == c)
+					return &n4->_hijos[i];
+			return NULL;
+		}
+		case NODO16: {
+			Nodo16 *n16 = static_cast<Nodo16*>(n);
+			int i = buscaEnNodo16(n16, c);
+			return i < 0 ? NULL : &n16->_hijos[i];
+		}
+		case NODO48: {
+			Nodo48 *n48 = static_cast<Nodo48*>(n);
+			return n48->_indice[c] ? &n48->_hijos[n48->_indice[c] - 1] : NULL;
+		}
+		default: {
+			Nodo256 *n256 = static_cast<Nodo256*>(n);
+			return n256->_hijos[c] ? &n256->_hijos[c] : NULL;
+		}
+		}
+	}
+
+	/**
+	 Devuelve el primer hijo (en orden de byte) a partir de
+	 la posicin pos, y deja en pos la posicin en la que se
+	 ha encontrado. NULL si no quedan hijos. En Nodo4 y Nodo16
+	 la posicin es el ndice en el vector ordenado; en Nodo48
+	 y Nodo256, el propio byte.
+	 */
+	static Nodo *hijoEnOrden(Interno *n, int &pos) {
+		switch (n->_tipo) {
+		case NODO4:
+			return pos < n->_numHijos ? static_cast<Nodo4*>(n)->_hijos[pos] : NULL;
+		case NODO16:
+			return pos < n->_numHijos ? static_cast<Nodo16*>(n)->_hijos[pos] : NULL;
+		case NODO48: {
+			Nodo48 *n48 = static_cast<Nodo48*>(n);
+			while ((pos < 256) && (n48->_indice[pos] == 0))
+				++pos;
+			return pos < 256 ? n48->_hijos[n48->_indice[pos] - 1] : NULL;
+		}
+		default: {
+			Nodo256 *n256 = static_cast<Nodo256*>(n);
+			while ((pos < 256) && (n256->_hijos[pos] == NULL))
+				++pos;
+			return pos < 256 ? n256->_hijos[pos] : NULL;
+		}
+		}
+	}
+
+	// //
+	// CRECIMIENTO Y DECRECIMIENTO DE LOS NODOS
+	// //
+
+	/** Copia la parte comn de los nodos internos. */
+	static void copiaCabecera(Interno *destino, const Interno *origen) {
+		destino->_prefijo = origen->_prefijo;
+		destino->_hoja = origen->_hoja;
+		destino->_numHijos = origen->_numHijos;
+	}
+
+	/**
+	 Aade al nodo interno *ref el hijo del byte c (que no
+	 debe tener). Si el nodo est lleno se sustituye por uno
+	 del tipo siguiente, actualizando *ref.
+	 */
+	static void anadeHijo(Nodo **ref, unsigned char c, Nodo *hijo) {
+		Interno *n = static_cast<Interno*>(*ref);
+		switch (n->_tipo) {
+		case NODO4: {
+			Nodo4 *n4 = static_cast<Nodo4*>(n);
+			if (n4->_numHijos < 4) {
+				int i = 0;
+				while ((i < n4->_numHijos) && (n4->_claves[i] < c))
+					++i;
+				std::memmove(n4->_claves + i + 1, n4->_claves + i, n4->_numHijos - i);
+				std::memmove(n4->_hijos + i + 1, n4->_hijos + i, (n4->_numHijos - i) * sizeof(Nodo*));
+				n4->_claves[i] = c;
+				n4->_hijos[i] = hijo;
+				n4->_numHijos++;
+				return;
+			}
+			Nodo16 *n16 = new Nodo16();
+			copiaCabecera(n16, n4);
+			std::memcpy(n16->_claves, n4->_claves, 4);
+			std::memcpy(n16->_hijos, n4->_hijos, 4 * sizeof(Nodo*));
+			delete n4;
+			*ref = n16;
+			break;
+		}
+		case NODO16: {
+			Nodo16 *n16 = static_cast<Nodo16*>(n);
+			if (n16->_numHijos < 16) {
+				int i = posicionEnNodo16(n16, c);
+				std::memmove(n16->_claves + i + 1, n16->_claves + i, n16->_numHijos - i);
+				std::memmove(n16->_hijos + i + 1, n16->_hijos + i, (n16->_numHijos - i) * sizeof(Nodo*));
+				n16->_claves[i] = c;
+				n16->_hijos[i] = hijo;
+				n16->_numHijos++;
+				return;
+			}
+			Nodo48 *n48 = new Nodo48();
+			copiaCabecera(n48, n16);
+			for (int i = 0; i < 16; ++i) {
+				n48->_hijos[i] = n16->_hijos[i];
+				n48->_indice[n16->_claves[i]] = i + 1;
+			}
+			delete n16;
+			*ref = n48;
+			break;
+		}
+		case NODO48: {
+			Nodo48 *n48 = static_cast<Nodo48*>(n);
+			if (n48->_numHijos < 48) {
+				int i = 0;
+				while (n48->_hijos[i] != NULL)
+					++i;
+				n48->_hijos[i] = hijo;
+				n48->_indice[c] = i + 1;
+				n48->_numHijos++;
+				return;
+			}
+			Nodo256 *n256 = new Nodo256();
+			copiaCabecera(n256, n48);
+			for (int b = 0; b < 256; ++b)
+				if (n48->_indice[b])
+					n256->_hijos[b] = n48->_hijos[n48->_indice[b] - 1];
+			delete n48;
+			*ref = n256;
+			break;
+		}
+		default: {
+			Nodo256 *n256 = static_cast<Nodo256*>(n);
+			n256->_hijos[c] = hijo;
+			n256->_numHijos++;
+			return;
+		}
+		}
+
+		// El nodo ha crecido; ahora seguro que hay sitio
+		anadeHijo(ref, c, hijo);
+	}
+
+	/** Quita del nodo interno n el hijo del byte c. */
+	static void quitaHijo(Interno *n, unsigned char c) {
+		switch (n->_tipo) {
+		case NODO4: {
+			Nodo4 *n4 = static_cast<Nodo4*>(n);
+			int i = 0;
+			while (n4->_claves[i] != c)
+				++i;
+			std::memmove(n4->_claves + i, n4->_claves + i + 1, n4->_numHijos - i - 1);
+			std::memmove(n4->_hijos + i, n4->_hijos + i + 1, (n4->_numHijos - i - 1) * sizeof(Nodo*));
+			break;
+		}
+		case NODO16: {
+			Nodo16 *n16 = static_cast<Nodo16*>(n);
+			int i = buscaEnNodo16(n16, c);
+			std::memmove(n16->_claves + i, n16->_claves + i + 1, n16->_numHijos - i - 1);
+			std::memmove(n16->_hijos + i, n16->_hijos + i + 1, (n16->_numHijos - i - 1) * sizeof(Nodo*));
+			break;
+		}
+		case NODO48: {
+			Nodo48 *n48 = static_cast<Nodo48*>(n);
+			n48->_hijos[n48->_indice[c] - 1] = NULL;
+			n48->_indice[c] = 0;
+			break;
+		}
+		default:
+			static_cast<Nodo256*>(n)->_hijos[c] = NULL;
+		}
+		n->_numHijos--;
+	}
+
+	/**
+	 Tras un borrado, ajusta el nodo interno *ref: si slo
+	 le queda una entrada (su hoja o un hijo) se elimina y
+	 esa entrada ocupa su lugar, alargando el prefijo si es
+	 un nodo interno; si tiene pocos hijos para su tipo se
+	 sustituye por uno del tipo anterior.
+	 */
+	static void ajusta(Nodo **ref) {
+		Interno *n = static_cast<Interno*>(*ref);
+		int entradas = n->_numHijos + (n->_hoja != NULL ? 1 : 0);
+
+		if (entradas == 0) {
+			liberaNodo(n);
+			*ref = NULL;
+		} else if (entradas == 1) {
+			if (n->_hoja != NULL)
+				*ref = n->_hoja;
+			else {
+				int pos = 0;
+				Nodo *hijo = hijoEnOrden(n, pos);
+				if (hijo->_tipo != HOJA) {
+					// Byte del hijo: posicin en Nodo48/256,
+					// o el byte guardado en Nodo4/16
+					unsigned char c = (n->_tipo == NODO4) ? static_cast<Nodo4*>(n)->_claves[0] :
+						(n->_tipo == NODO16) ? static_cast<Nodo16*>(n)->_claves[0] :
+						(unsigned char)pos;
+					Interno *in = static_cast<Interno*>(hijo);
+					in->_prefijo = n->_prefijo + (char)c + in->_prefijo;
+				}
+				*ref = hijo;
+			}
+			liberaNodo(n);
+		} else if ((n->_tipo == NODO16) && (n->_numHijos <= 3)) {
+			Nodo16 *n16 = static_cast<Nodo16*>(n);
+			Nodo4 *n4 = new Nodo4();
+			copiaCabecera(n4, n16);
+			std::memcpy(n4->_claves, n16->_claves, n16->_numHijos);
+			std::memcpy(n4->_hijos, n16->_hijos, n16->_numHijos * sizeof(Nodo*));
+			liberaNodo(n16);
+			*ref = n4;
+		} else if ((n->_tipo == NODO48) && (n->_numHijos <= 12)) {
+			Nodo48 *n48 = static_cast<Nodo48*>(n);
+			Nodo16 *n16 = new Nodo16();
+			copiaCabecera(n16, n48);
+			int j = 0;
+			for (int b = 0; b < 256; ++b)
+				if (n48->_indice[b]) {
+					n16->_claves[j] = (unsigned char)b;
+					n16->_hijos[j] = n48->_hijos[n48->_indice[b] - 1];
+					++j;
+				}
+			liberaNodo(n48);
+			*ref = n16;
+		} else if ((n->_tipo == NODO256) && (n->_numHijos <= 37)) {
+			Nodo256 *n256 = static_cast<Nodo256*>(n);
+			Nodo48 *n48 = new Nodo48();
+			copiaCabecera(n48, n256);
+			int j = 0;
+			for (int b = 0; b < 256; ++b)
+				if (n256->_hijos[b] != NULL) {
+					n48->_hijos[j] = n256->_hijos[b];
+					n48->_indice[b] = j + 1;
+					++j;
+				}
+			liberaNodo(n256);
+			*ref = n48;
+		}
+	}
+
+	// //
+	// OPERACIONES AUXILIARES
+	// //
+
+	/**
+	 Nmero de bytes del prefijo de n que coinciden con
+	 la clave a partir de la posicin prof.
+	 */
+	static size_t coincidencia(const Interno *n, const Clave &clave, size_t prof) {
+		size_t i = 0;
+		size_t max = n->_prefijo.size();
+		if (clave.size() - prof < max)
+			max = clave.size() - prof;
+		while ((i < max) && (n->_prefijo[i] == clave[prof + i]))
+			++i;
+		return i;
+	}
+
+	/**
+	 Cuelga la hoja h del nodo n (recin creado, con sitio)
+	 en la posicin que le corresponde a profundidad prof:
+	 como hoja propia si su clave termina ah o como hijo
+	 del byte siguiente.
+	 */
+	static void cuelga(Nodo4 *n, Hoja *h, size_t prof) {
+		if (h->_clave.size() == prof)
+			n->_hoja = h;
+		else {
+			Nodo *aux = n;
+			anadeHijo(&aux, (unsigned char)h->_clave[prof], h);
+		}
+	}
+
+	Hoja *buscaAux(const Clave &clave) const {
+		Nodo *n = _ra;
+		size_t prof = 0;
+		while (n != NULL) {
+			if (n->_tipo == HOJA) {
+				Hoja *h = static_cast<Hoja*>(n);
+				return h->_clave == clave ? h : NULL;
+			}
+
+			Interno *in = static_cast<Interno*>(n);
+			size_t tamPrefijo = in->_prefijo.size();
+			if ((clave.size() - prof < tamPrefijo) ||
+				(std::memcmp(in->_prefijo.data(), clave.data() + prof, tamPrefijo) != 0))
+				return NULL;
+			prof += tamPrefijo;
+
+			if (prof == clave.size())
+				return in->_hoja;
+
+			Nodo **hijo = buscaHijo(in, (unsigned char)clave[prof]);
+			if (hijo == NULL)
+				return NULL;
+			n = *hijo;
+			++prof;
+		}
+		return NULL;
+	}
+
+	/**
+	 Inserta la pareja en la estructura apuntada por *ref,
+	 cuyos prof primeros bytes de clave ya se han consumido.
+	 */
+	static void insertaAux(Nodo **ref, const Clave &clave, size_t prof, const Valor &valor) {
+		Nodo *n = *ref;
+		if (n == NULL) {
+			*ref = new Hoja(clave, valor);
+			return;
+		}
+
+		if (n->_tipo == HOJA) {
+			Hoja *h = static_cast<Hoja*>(n);
+			if (h->_clave == clave) {
+				h->_valor = valor;
+				return;
+			}
+
+			// Dos claves distintas: un Nodo4 con su
+			// prefijo comn y las dos hojas debajo
+			size_t i = prof;
+			while ((i < h->_clave.size()) && (i < clave.size()) &&
+				   (h->_clave[i] == clave[i]))
+				++i;
+			Nodo4 *nuevo = new Nodo4();
+			nuevo->_prefijo = clave.substr(prof, i - prof);
+			cuelga(nuevo, h, i);
+			cuelga(nuevo, new Hoja(clave, valor), i);
+			*ref = nuevo;
+			return;
+		}
+
+		Interno *in = static_cast<Interno*>(n);
+		size_t iguales = coincidencia(in, clave, prof);
+		if (iguales < in->_prefijo.size()) {
+			// La clave se separa a mitad del prefijo: un Nodo4
+			// nuevo con la parte comn, del que cuelgan el nodo
+			// viejo (con el resto del prefijo) y la hoja nueva
+			Nodo4 *nuevo = new Nodo4();
+			nuevo->_prefijo = in->_prefijo.substr(0, iguales);
+			unsigned char c = (unsigned char)in->_prefijo[iguales];
+			in->_prefijo.erase(0, iguales + 1);
+			Nodo *aux = nuevo;
+			anadeHijo(&aux, c, in);
+			cuelga(nuevo, new Hoja(clave, valor), prof + iguales);
+			*ref = nuevo;
+			return;
+		}
+
+		prof += iguales;
+		if (prof == clave.size()) {
+			if (in->_hoja != NULL)
+				in->_hoja->_valor = valor;
+			else
+				in->_hoja = new Hoja(clave, valor);
+			return;
+		}
+
+		Nodo **hijo = buscaHijo(in, (unsigned char)clave[prof]);
+		if (hijo != NULL)
+			insertaAux(hijo, clave, prof + 1, valor);
+		else
+			anadeHijo(ref, (unsigned char)clave[prof], new Hoja(clave, valor));
+	}
+
+	/**
+	 Borra la clave de la estructura apuntada por *ref,
+	 cuyos prof primeros bytes de clave ya se han consumido.
+	 */
+	static void borraAux(Nodo **ref, const Clave &clave, size_t prof) {
+		Nodo *n = *ref;
+		if (n == NULL)
+			return;
+
+		if (n->_tipo == HOJA) {
+			if (static_cast<Hoja*>(n)->_clave == clave) {
+				delete static_cast<Hoja*>(n);
+				*ref = NULL;
+			}
+			return;
+		}
+
+		Interno *in = static_cast<Interno*>(n);
+		if (coincidencia(in, clave, prof) < in->_prefijo.size())
+			return;
+		prof += in->_prefijo.size();
+
+		if (prof == clave.size()) {
+			if (in->_hoja == NULL)
+				return;
+			delete in->_hoja;
+			in->_hoja = NULL;
+		} else {
+			unsigned char c = (unsigned char)clave[prof];
+			Nodo **hijo = buscaHijo(in, c);
+			if (hijo == NULL)
+				return;
+			borraAux(hijo, clave, prof + 1);
+			if (*hijo != NULL)
+				return;
+			quitaHijo(in, c);
+		}
+		ajusta(ref);
+	}
+
+	/**
+	 Libera un nodo interno sin tocar sus hijos ni su hoja.
+	 */
+	static void liberaNodo(Interno *n) {
+		switch (n->_tipo) {
+		case NODO4: delete static_cast<Nodo4*>(n); break;
+		case NODO16: delete static_cast<Nodo16*>(n); break;
+		case NODO48: delete static_cast<Nodo48*>(n); break;
+		default: delete static_cast<Nodo256*>(n);
+		}
+	}
+
+	/**
+	 Elimina todos los nodos de la estructura que comienza
+	 en n (que puede ser NULL).
+	 */
+	static void libera(Nodo *n) {
+		if (n == NULL)
+			return;
+		if (n->_tipo == HOJA) {
+			delete static_cast<Hoja*>(n);
+			return;
+		}
+
+		Interno *in = static_cast<Interno*>(n);
+		int pos = 0;
+		Nodo *hijo;
+		while ((hijo = hijoEnOrden(in, pos)) != NULL) {
+			libera(hijo);
+			++pos;
+		}
+		delete in->_hoja;
+		liberaNodo(in);
+	}
+
+	static Nodo *copiaAux(Nodo *n) {
+		if (n == NULL)
+			return NULL;
+
+		Interno *copia;
+		switch (n->_tipo) {
+		case HOJA: {
+			Hoja *h = static_cast<Hoja*>(n);
+			return new Hoja(h->_clave, h->_valor);
+		}
+		case NODO4: copia = new Nodo4(*static_cast<Nodo4*>(n)); break;
+		case NODO16: copia = new Nodo16(*static_cast<Nodo16*>(n)); break;
+		case NODO48: copia = new Nodo48(*static_cast<Nodo48*>(n)); break;
+		default: copia = new Nodo256(*static_cast<Nodo256*>(n));
+		}
+
+		// La copia tiene los mismos punteros que el original;
+		// se sustituyen uno a uno por copias de los hijos
+		if (copia->_hoja != NULL)
+			copia->_hoja = static_cast<Hoja*>(copiaAux(copia->_hoja));
+		int pos = 0;
+		Nodo *hijo;
+		while ((hijo = hijoEnOrden(copia, pos)) != NULL) {
+			Nodo **hueco = (copia->_tipo == NODO4) ? &static_cast<Nodo4*>(copia)->_hijos[pos] :
+				(copia->_tipo == NODO16) ? &static_cast<Nodo16*>(copia)->_hijos[pos] :
+				(copia->_tipo == NODO48) ?
+					&static_cast<Nodo48*>(copia)->_hijos[static_cast<Nodo48*>(copia)->_indice[pos] - 1] :
+				&static_cast<Nodo256*>(copia)->_hijos[pos];
+			*hueco = copiaAux(hijo);
+			++pos;
+		}
+		return copia;
+	}
+
+	/**
+	 Puntero a la raz de la estructura jerrquica
+	 de nodos.
+	 */
+	Nodo *_ra;
+};
+
+#endif // __ARBUSART_H
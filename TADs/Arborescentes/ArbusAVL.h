@@ -0,0 +1,663 @@
+/**
+  @file ArbusAVL.h
+
+  Implementacin del TAD Arbol de Bsqueda equilibrado
+  (AVL) basada en la operacin join, con operaciones
+  de conjuntos (unin, interseccin, diferencia) y de
+  divisin por una clave.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSAVL_H
+#define __ARBUSAVL_H
+
+#include "Excepciones.h"
+
+#include "Pila.h" // Usado internamente por los iteradores
+
+#include <thread> // Paralelismo fork-join en las operaciones de conjuntos
+
+/**
+ Implementacin del TAD Arbus mediante rboles AVL en la
+ que todas las operaciones que modifican la estructura se
+ expresan en trminos de una nica operacin de
+ reequilibrado, join(iz, nodo, dr), que une dos rboles
+ (todas las claves de iz menores que todas las de dr)
+ poniendo un nodo entre ellos. Sobre join se construyen:
+
+ - divide(clave): separa el rbol en las claves menores
+ que la dada y las mayores o iguales. O(log n).
+
+ - inserta(clave, valor) y borra(clave): dividir por la
+ clave y volver a unir las dos mitades (con o sin el nodo
+ de la clave). O(log n).
+
+ - une(otro), intersecta(otro), diferencia(otro):
+ algoritmos de conjuntos "divide y vencers": se divide
+ uno de los rboles por la raz del otro, se resuelven
+ recursivamente las dos mitades y se vuelven a juntar con
+ join. Con m <= n el nmero de claves del rbol pequeo
+ y del grande, el coste es O(m log(n/m + 1)). Las dos
+ llamadas recursivas son independientes, por lo que se
+ pueden ejecutar en paralelo (fork-join).
+
+ Las operaciones de conjuntos reutilizan los nodos de los
+ dos rboles sin hacer copias, por lo que el rbol pasado
+ como parmetro queda vaco tras la operacin.
+
+ El resto de operaciones (consulta, esta, esVacio y los
+ iteradores) se comportan igual que en Arbus.
+ */
+template <class Clave, class Valor>
+class ArbusAVL {
+private:
+	/**
+	 Clase nodo que almacena internamente la pareja (clave, valor),
+	 los punteros al hijo izquierdo y al hijo derecho y la
+	 altura del subrbol que comienza en l.
+	 */
+	class Nodo {
+	public:
+		Nodo() : _iz(NULL), _dr(NULL), _altura(1) {}
+		Nodo(const Clave &clave, const Valor &valor)
+			: _clave(clave), _valor(valor), _iz(NULL), _dr(NULL), _altura(1) {}
+		Nodo(Nodo *iz, const Clave &clave, const Valor &valor, Nodo *dr)
+			: _clave(clave), _valor(valor), _iz(iz), _dr(dr), _altura(1) {
+			actualiza(this);
+		}
+
+		Clave _clave;
+		Valor _valor;
+		Nodo *_iz;
+		Nodo *_dr;
+		int _altura;
+	};
+
+public:
+
+	/**
+	 Altura mnima que tienen que tener los dos rboles
+	 de una operacin de conjuntos para que sus dos
+	 mitades se resuelvan en hilos distintos. Un AVL
+	 de altura 12 tiene al menos 376 nodos.
+	 */
+	enum { UMBRAL_PARALELO = 12 };
+
+	/** Constructor; operacion ArbolVacio */
+	ArbusAVL() : _ra(NULL) {
+	}
+
+	/** Destructor; elimina la estructura jerrquica de nodos. */
+	~ArbusAVL() {
+		libera();
+		_ra = NULL;
+	}
+
+	/**
+	 Operacin generadora que aade una nueva clave/valor
+	 a un rbol de bsqueda.
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave. Si la clave
+	 ya se haba insertado previamente, sustituimos el valor
+	 viejo por el nuevo.
+	 */
+	void inserta(const Clave &clave, const Valor &valor) {
+		Nodo *iz, *dr;
+		Nodo *p = divideAux(_ra, clave, iz, dr);
+		if (p == NULL)
+			p = new Nodo(clave, valor);
+		else
+			p->_valor = valor;
+		_ra = join(iz, p, dr);
+	}
+
+	/**
+	 Operacin modificadora que elimina una clave del rbol.
+	 Si la clave no exista la operacin no tiene efecto.
+	 @param clave Clave a eliminar.
+	 */
+	void borra(const Clave &clave) {
+		Nodo *iz, *dr;
+		Nodo *p = divideAux(_ra, clave, iz, dr);
+		delete p;
+		_ra = join2(iz, dr);
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada. Es un error preguntar por una clave
+	 que no existe.
+	 @param clave Clave por la que se pregunta.
+	 */
+	const Valor &consulta(const Clave &clave) const {
+		Nodo *p = buscaAux(_ra, clave);
+		if (p == NULL)
+			throw EClaveErronea();
+
+		return p->_valor;
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el rbol de bsqueda.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) const {
+		return buscaAux(_ra, clave) != NULL;
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _ra == NULL;
+	}
+
+	/**
+	 Devuelve la altura del rbol (0 si es vaco).
+	 */
+	int talla() const {
+		return altura(_ra);
+	}
+
+	// //
+	// OPERACIONES DE CONJUNTOS
+	// //
+
+	/**
+	 Divide el rbol por una clave: el rbol se queda con
+	 las claves estrictamente menores que la dada y el resto
+	 (la propia clave, si estaba, y las mayores) se devuelven
+	 en un rbol nuevo. O(log n).
+	 @param clave Clave por la que dividir.
+	 @return rbol con las claves mayores o iguales a clave.
+	 */
+	ArbusAVL divide(const Clave &clave) {
+		Nodo *iz, *dr;
+		Nodo *p = divideAux(_ra, clave, iz, dr);
+		_ra = iz;
+		if (p != NULL)
+			dr = join(NULL, p, dr);
+		return ArbusAVL(dr);
+	}
+
+	/**
+	 Aade al rbol todas las parejas de otro. Si una clave
+	 aparece en los dos, se queda el valor de otro (igual que
+	 si se hubieran insertado con inserta). otro queda vaco.
+	 @param otro rbol a unir; queda vaco.
+	 @param paralelo Si es true, las llamadas recursivas sobre
+	 subrboles grandes se ejecutan en hilos distintos.
+	 */
+	void une(ArbusAVL &otro, bool paralelo = false) {
+		if (this == &otro)
+			return;
+		_ra = uneAux(_ra, otro._ra, hilos(paralelo));
+		otro._ra = NULL;
+	}
+
+	/**
+	 Deja en el rbol slo las claves que tambin aparecen
+	 en otro, con los valores que tenan en este rbol.
+	 otro queda vaco.
+	 @param otro rbol con el que intersecar; queda vaco.
+	 @param paralelo Como en une.
+	 */
+	void intersecta(ArbusAVL &otro, bool paralelo = false) {
+		if (this == &otro)
+			return;
+		_ra = intersectaAux(_ra, otro._ra, hilos(paralelo));
+		otro._ra = NULL;
+	}
+
+	/**
+	 Elimina del rbol las claves que aparecen en otro.
+	 otro queda vaco.
+	 @param otro rbol con las claves a eliminar; queda vaco.
+	 @param paralelo Como en une.
+	 */
+	void diferencia(ArbusAVL &otro, bool paralelo = false) {
+		if (this == &otro) {
+			libera();
+			_ra = NULL;
+			return;
+		}
+		_ra = diferenciaAux(_ra, otro._ra, hilos(paralelo));
+		otro._ra = NULL;
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Clase interna que implementa un iterador que
+	 recorre las claves del rbol en orden.
+	 */
+	class Iterador {
+	public:
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+
+			// Si hay hijo derecho, saltamos al primero
+			// en inorden del hijo derecho
+			if (_act->_dr)
+				_act = primeroInOrden(_act->_dr);
+			else {
+				// Si no, vamos al primer ascendiente
+				// no visitado.
+				if (_ascendientes.esVacia())
+					_act = NULL;
+				else {
+					_act = _ascendientes.cima();
+					_ascendientes.desapila();
+				}
+			}
+		}
+
+		const Clave &clave() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_clave;
+		}
+
+		const Valor &valor() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_valor;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusAVL;
+
+		Iterador() : _act(NULL) {}
+		Iterador(Nodo *act) {
+			_act = primeroInOrden(act);
+		}
+
+		Nodo *primeroInOrden(Nodo *p) {
+			if (p == NULL)
+				return NULL;
+
+			while (p->_iz != NULL) {
+				_ascendientes.apila(p);
+				p = p->_iz;
+			}
+			return p;
+		}
+
+		// Puntero al nodo actual del recorrido
+		// NULL si hemos llegado al final.
+		Nodo *_act;
+
+		// Ascendientes del nodo actual
+		// an por visitar
+		Pila<Nodo*> _ascendientes;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(_ra);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador(NULL);
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbusAVL(const ArbusAVL<Clave, Valor> &other) : _ra(NULL) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbusAVL<Clave, Valor> &operator=(const ArbusAVL<Clave, Valor> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	/**
+	 Constructor protegido que crea un rbol
+	 a partir de una estructura jerrquica de nodos
+	 previamente creada. Se utiliza en divide.
+	 */
+	ArbusAVL(Nodo *raiz) : _ra(raiz) {
+	}
+
+	void libera() {
+		libera(_ra);
+	}
+
+	void copia(const ArbusAVL &other) {
+		_ra = copiaAux(other._ra);
+	}
+
+private:
+
+	static void libera(Nodo *ra) {
+		if (ra != NULL) {
+			libera(ra->_iz);
+			libera(ra->_dr);
+			delete ra;
+		}
+	}
+
+	static Nodo *copiaAux(Nodo *ra) {
+		if (ra == NULL)
+			return NULL;
+
+		return new Nodo(copiaAux(ra->_iz),
+						ra->_clave, ra->_valor,
+						copiaAux(ra->_dr));
+	}
+
+	static Nodo *buscaAux(Nodo *p, const Clave &clave) {
+		while (p != NULL) {
+			if (p->_clave == clave)
+				return p;
+			else if (clave < p->_clave)
+				p = p->_iz;
+			else
+				p = p->_dr;
+		}
+		return NULL;
+	}
+
+	// //
+	// REEQUILIBRADO: ROTACIONES Y JOIN
+	// //
+
+	static int altura(Nodo *p) {
+		return p == NULL ? 0 : p->_altura;
+	}
+
+	/** Recalcula la altura de un nodo a partir de la de sus hijos. */
+	static void actualiza(Nodo *p) {
+		int iz = altura(p->_iz);
+		int dr = altura(p->_dr);
+		p->_altura = 1 + (iz > dr ? iz : dr);
+	}
+
+	/** Enlaza un nodo con sus nuevos hijos y actualiza su altura. */
+	static Nodo *enlaza(Nodo *iz, Nodo *p, Nodo *dr) {
+		p->_iz = iz;
+		p->_dr = dr;
+		actualiza(p);
+		return p;
+	}
+
+	static Nodo *rotaIz(Nodo *p) {
+		Nodo *dr = p->_dr;
+		p->_dr = dr->_iz;
+		actualiza(p);
+		dr->_iz = p;
+		actualiza(dr);
+		return dr;
+	}
+
+	static Nodo *rotaDr(Nodo *p) {
+		Nodo *iz = p->_iz;
+		p->_iz = iz->_dr;
+		actualiza(p);
+		iz->_dr = p;
+		actualiza(iz);
+		return iz;
+	}
+
+	/**
+	 Une dos estructuras AVL poniendo el nodo p entre ellas.
+	 Todas las claves de iz deben ser menores que la de p
+	 y todas las de dr mayores. El coste es proporcional a
+	 la diferencia de alturas de iz y dr.
+	 @return Raz de la estructura resultante (equilibrada).
+	 */
+	static Nodo *join(Nodo *iz, Nodo *p, Nodo *dr) {
+		if (altura(iz) > altura(dr) + 1)
+			return joinDr(iz, p, dr);
+		else if (altura(dr) > altura(iz) + 1)
+			return joinIz(iz, p, dr);
+		else
+			return enlaza(iz, p, dr);
+	}
+
+	/**
+	 join cuando iz es ms alto que dr: descendemos por la
+	 rama derecha de iz hasta un subrbol de altura parecida
+	 a la de dr, colgamos all el nodo y reequilibramos al
+	 volver.
+	 */
+	static Nodo *joinDr(Nodo *iz, Nodo *p, Nodo *dr) {
+		Nodo *c = iz->_dr;
+		if (altura(c) <= altura(dr) + 1) {
+			enlaza(c, p, dr);
+			if (altura(p) <= altura(iz->_iz) + 1)
+				return enlaza(iz->_iz, iz, p);
+			else
+				return rotaIz(enlaza(iz->_iz, iz, rotaDr(p)));
+		} else {
+			Nodo *nuevo = joinDr(c, p, dr);
+			enlaza(iz->_iz, iz, nuevo);
+			if (altura(nuevo) <= altura(iz->_iz) + 1)
+				return iz;
+			else
+				return rotaIz(iz);
+		}
+	}
+
+	/** Simtrico de joinDr, cuando dr es ms alto que iz. */
+	static Nodo *joinIz(Nodo *iz, Nodo *p, Nodo *dr) {
+		Nodo *c = dr->_iz;
+		if (altura(c) <= altura(iz) + 1) {
+			enlaza(iz, p, c);
+			if (altura(p) <= altura(dr->_dr) + 1)
+				return enlaza(p, dr, dr->_dr);
+			else
+				return rotaDr(enlaza(rotaIz(p), dr, dr->_dr));
+		} else {
+			Nodo *nuevo = joinIz(iz, p, c);
+			enlaza(nuevo, dr, dr->_dr);
+			if (altura(nuevo) <= altura(dr->_dr) + 1)
+				return dr;
+			else
+				return rotaDr(dr);
+		}
+	}
+
+	/**
+	 Separa el ltimo nodo (clave mxima) de la estructura,
+	 que no puede ser vaca.
+	 @param ultimo Parmetro de salida con el nodo separado.
+	 @return Raz de la estructura sin ese nodo.
+	 */
+	static Nodo *quitaUltimo(Nodo *p, Nodo *&ultimo) {
+		if (p->_dr == NULL) {
+			ultimo = p;
+			return p->_iz;
+		}
+		Nodo *dr = quitaUltimo(p->_dr, ultimo);
+		return join(p->_iz, p, dr);
+	}
+
+	/**
+	 Une dos estructuras (las claves de iz menores que las
+	 de dr) sin nodo intermedio: se usa como tal el ltimo
+	 de iz.
+	 */
+	static Nodo *join2(Nodo *iz, Nodo *dr) {
+		if (iz == NULL)
+			return dr;
+		Nodo *ultimo;
+		Nodo *resto = quitaUltimo(iz, ultimo);
+		return join(resto, ultimo, dr);
+	}
+
+	/**
+	 Divide la estructura p en dos: la de las claves menores
+	 que la dada y la de las mayores. El nodo con la propia
+	 clave, si existe, queda fuera de ambas y se devuelve.
+	 @param iz Parmetro de salida con las claves menores.
+	 @param dr Parmetro de salida con las claves mayores.
+	 @return Nodo con la clave, o NULL si no estaba.
+	 */
+	static Nodo *divideAux(Nodo *p, const Clave &clave, Nodo *&iz, Nodo *&dr) {
+		if (p == NULL) {
+			iz = dr = NULL;
+			return NULL;
+		}
+
+		Nodo *ret;
+		if (p->_clave == clave) {
+			iz = p->_iz;
+			dr = p->_dr;
+			enlaza(NULL, p, NULL);
+			return p;
+		} else if (clave < p->_clave) {
+			Nodo *medio;
+			ret = divideAux(p->_iz, clave, iz, medio);
+			dr = join(medio, p, p->_dr);
+		} else {
+			Nodo *medio;
+			ret = divideAux(p->_dr, clave, medio, dr);
+			iz = join(p->_iz, p, medio);
+		}
+		return ret;
+	}
+
+	// //
+	// OPERACIONES DE CONJUNTOS (DIVIDE Y VENCERS)
+	// //
+
+	/**
+	 Nmero de hilos con el que empiezan las operaciones
+	 de conjuntos (1 si no son paralelas).
+	 */
+	static unsigned int hilos(bool paralelo) {
+		if (!paralelo)
+			return 1;
+		unsigned int n = std::thread::hardware_concurrency();
+		return n > 0 ? n : 2;
+	}
+
+	/**
+	 Decide si las dos llamadas recursivas sobre los
+	 subrboles de t1 y t2 merecen ejecutarse en paralelo.
+	 */
+	static bool enParalelo(Nodo *t1, Nodo *t2, unsigned int hilos) {
+		return (hilos > 1) &&
+			(altura(t1) >= UMBRAL_PARALELO) && (altura(t2) >= UMBRAL_PARALELO);
+	}
+
+	static Nodo *uneAux(Nodo *t1, Nodo *t2, unsigned int hilos) {
+		if (t1 == NULL)
+			return t2;
+		if (t2 == NULL)
+			return t1;
+
+		// Dividimos t1 por la raz de t2; si la clave ya
+		// estaba en t1 nos quedamos con el nodo de t2.
+		Nodo *iz1, *dr1;
+		bool paralelo = enParalelo(t1, t2, hilos);
+		delete divideAux(t1, t2->_clave, iz1, dr1);
+
+		Nodo *iz2 = t2->_iz, *dr2 = t2->_dr;
+		Nodo *iz, *dr;
+		if (paralelo) {
+			std::thread hiloIz([&]() { iz = uneAux(iz1, iz2, hilos / 2); });
+			dr = uneAux(dr1, dr2, hilos - hilos / 2);
+			hiloIz.join();
+		} else {
+			iz = uneAux(iz1, iz2, 1);
+			dr = uneAux(dr1, dr2, 1);
+		}
+		return join(iz, t2, dr);
+	}
+
+	static Nodo *intersectaAux(Nodo *t1, Nodo *t2, unsigned int hilos) {
+		if ((t1 == NULL) || (t2 == NULL)) {
+			libera(t1);
+			libera(t2);
+			return NULL;
+		}
+
+		// Dividimos t2 por la raz de t1; la raz de t1 se
+		// conserva slo si su clave estaba en t2.
+		Nodo *iz2, *dr2;
+		bool paralelo = enParalelo(t1, t2, hilos);
+		Nodo *repetido = divideAux(t2, t1->_clave, iz2, dr2);
+		bool esta = (repetido != NULL);
+		delete repetido;
+
+		Nodo *iz1 = t1->_iz, *dr1 = t1->_dr;
+		Nodo *iz, *dr;
+		if (paralelo) {
+			std::thread hiloIz([&]() { iz = intersectaAux(iz1, iz2, hilos / 2); });
+			dr = intersectaAux(dr1, dr2, hilos - hilos / 2);
+			hiloIz.join();
+		} else {
+			iz = intersectaAux(iz1, iz2, 1);
+			dr = intersectaAux(dr1, dr2, 1);
+		}
+
+		if (esta)
+			return join(iz, t1, dr);
+		delete t1;
+		return join2(iz, dr);
+	}
+
+	static Nodo *diferenciaAux(Nodo *t1, Nodo *t2, unsigned int hilos) {
+		if ((t1 == NULL) || (t2 == NULL)) {
+			libera(t2);
+			return t1;
+		}
+
+		// Dividimos t1 por la raz de t2, descartando
+		// el nodo con esa clave si lo hay.
+		Nodo *iz1, *dr1;
+		bool paralelo = enParalelo(t1, t2, hilos);
+		delete divideAux(t1, t2->_clave, iz1, dr1);
+
+		Nodo *iz2 = t2->_iz, *dr2 = t2->_dr;
+		delete t2;
+		Nodo *iz, *dr;
+		if (paralelo) {
+			std::thread hiloIz([&]() { iz = diferenciaAux(iz1, iz2, hilos / 2); });
+			dr = diferenciaAux(dr1, dr2, hilos - hilos / 2);
+			hiloIz.join();
+		} else {
+			iz = diferenciaAux(iz1, iz2, 1);
+			dr = diferenciaAux(dr1, dr2, 1);
+		}
+		return join2(iz, dr);
+	}
+
+	/**
+	 Puntero a la raz de la estructura jerrquica
+	 de nodos.
+	 */
+	Nodo *_ra;
+};
+
+#endif // __ARBUSAVL_H
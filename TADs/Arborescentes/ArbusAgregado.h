@@ -0,0 +1,540 @@
+/**
+  @file ArbusAgregado.h
+
+  Implementacin de un rbol de bsqueda aumentado que
+  mantiene en cada nodo un agregado (suma, mnimo, mximo...)
+  de los valores de su subrbol.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSAGREGADO_H
+#define __ARBUSAGREGADO_H
+
+#include "Excepciones.h"
+
+#include "Pila.h" // Usado internamente por los iteradores
+
+#include <limits> // Elementos neutros de MonoideMinimo y MonoideMaximo
+
+/**
+ Monoides predefinidos para ArbusAgregado. Un monoide es
+ una operacin asociativa con elemento neutro; se describe
+ con una clase con dos mtodos estticos:
+
+   static T neutro();
+   static T opera(const T &a, const T &b);
+
+ La operacin no tiene por qu ser conmutativa: el agregado
+ de un rango combina los valores en el orden de sus claves.
+ */
+template <class T>
+class MonoideSuma {
+public:
+	static T neutro() { return T(); }
+	static T opera(const T &a, const T &b) { return a + b; }
+};
+
+template <class T>
+class MonoideMinimo {
+public:
+	static T neutro() { return std::numeric_limits<T>::max(); }
+	static T opera(const T &a, const T &b) { return b < a ? b : a; }
+};
+
+template <class T>
+class MonoideMaximo {
+public:
+	static T neutro() { return std::numeric_limits<T>::lowest(); }
+	static T opera(const T &a, const T &b) { return a < b ? b : a; }
+};
+
+/**
+ Diccionario ordenado con la interfaz de Arbus que,
+ adems, responde en O(log n) a consultas de agregado
+ sobre un rango de claves: la suma (o el mnimo, el
+ mximo...) de los valores de todas las claves de
+ [desde, hasta).
+
+ Cada nodo guarda, adems de su pareja, el agregado de
+ los valores de su subrbol. Un rango de claves se
+ descompone en O(log n) subrboles completos ms los nodos
+ del camino, as que no hace falta visitar cada clave. El
+ rbol se mantiene equilibrado (AVL) para que la altura, y
+ con ella el coste de las operaciones, sea O(log n) sea cual
+ sea el orden de insercin. Insertar, borrar o modificar un
+ valor recalcula los agregados del camino hasta la raz.
+
+ Por ejemplo, con claves enteras dispersas (columnas,
+ instantes de tiempo...) y MonoideSuma, agregado(a, b) es la suma
+ de los valores de las claves a, a+1, ..., b-1 que existan.
+
+ El parmetro Monoide indica la operacin; por defecto es
+ MonoideSuma<Valor>. Ver MonoideSuma, MonoideMinimo y MonoideMaximo.
+ */
+template <class Clave, class Valor, class Monoide = MonoideSuma<Valor> >
+class ArbusAgregado {
+private:
+	/**
+	 Clase nodo que almacena internamente la pareja (clave, valor),
+	 los punteros a los hijos, la altura del subrbol y el
+	 agregado de todos sus valores.
+	 */
+	class Nodo {
+	public:
+		Nodo(const Clave &clave, const Valor &valor)
+			: _clave(clave), _valor(valor), _agregado(valor),
+			  _iz(NULL), _dr(NULL), _altura(1) {}
+
+		Clave _clave;
+		Valor _valor;
+		Valor _agregado;
+		Nodo *_iz;
+		Nodo *_dr;
+		int _altura;
+	};
+
+public:
+
+	/** Constructor; operacion ArbolVacio */
+	ArbusAgregado() : _ra(NULL) {
+	}
+
+	/** Destructor; elimina la estructura jerrquica de nodos. */
+	~ArbusAgregado() {
+		libera();
+		_ra = NULL;
+	}
+
+	/**
+	 Operacin generadora que aade una nueva clave/valor
+	 al rbol. O(log n).
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave. Si la clave
+	 ya se haba insertado previamente, sustituimos el valor
+	 viejo por el nuevo.
+	 */
+	void inserta(const Clave &clave, const Valor &valor) {
+		_ra = insertaAux(_ra, clave, valor, false);
+	}
+
+	/**
+	 Combina un valor con el asociado a una clave:
+	 si la clave existe su valor pasa a ser
+	 Monoide::opera(viejo, valor); si no, se inserta con
+	 ese valor. Con MonoideSuma es el "consulta(clave) += valor"
+	 habitual al acumular por clave, en una sola bajada.
+	 O(log n).
+	 @param clave Clave a actualizar.
+	 @param valor Valor a acumular.
+	 */
+	void acumula(const Clave &clave, const Valor &valor) {
+		_ra = insertaAux(_ra, clave, valor, true);
+	}
+
+	/**
+	 Operacin modificadora que elimina una clave del rbol.
+	 Si la clave no exista la operacin no tiene efecto.
+	 O(log n).
+	 @param clave Clave a eliminar.
+	 */
+	void borra(const Clave &clave) {
+		_ra = borraAux(_ra, clave);
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada. Es un error preguntar por una clave
+	 que no existe. El valor no se puede modificar a travs
+	 de la referencia (los agregados quedaran desfasados);
+	 para ello estn inserta y acumula.
+	 @param clave Clave por la que se pregunta.
+	 */
+	const Valor &consulta(const Clave &clave) const {
+		Nodo *p = buscaAux(_ra, clave);
+		if (p == NULL)
+			throw EClaveErronea();
+
+		return p->_valor;
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el rbol de bsqueda.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) const {
+		return buscaAux(_ra, clave) != NULL;
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _ra == NULL;
+	}
+
+	/**
+	 Devuelve el agregado de los valores de todas las
+	 claves del intervalo [desde, hasta), combinados en orden
+	 de clave; Monoide::neutro() si no hay ninguna. O(log n).
+
+	 Se baja hasta el primer nodo cuya clave est dentro del
+	 intervalo (el que lo "parte"). Desde l, por la izquierda
+	 slo interesan las claves >= desde y por la derecha las
+	 claves < hasta, y cada una de esas dos bajadas suma
+	 subrboles enteros usando sus agregados.
+	 @param desde Primera clave del rango (incluida).
+	 @param hasta Clave lmite del rango (excluida).
+	 */
+	Valor agregado(const Clave &desde, const Clave &hasta) const {
+		Nodo *p = _ra;
+		while (p != NULL) {
+			if (p->_clave < desde)
+				p = p->_dr;
+			else if (!(p->_clave < hasta))
+				p = p->_iz;
+			else
+				break;
+		}
+		if (p == NULL)
+			return Monoide::neutro();
+
+		return Monoide::opera(
+			Monoide::opera(agregadoDesde(p->_iz, desde), p->_valor),
+			agregadoHasta(p->_dr, hasta));
+	}
+
+	/**
+	 Devuelve el agregado de los valores de todo el rbol.
+	 O(1).
+	 */
+	Valor agregadoTotal() const {
+		return agregado(_ra);
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Clase interna que implementa un iterador que
+	 recorre las claves del rbol en orden.
+	 */
+	class Iterador {
+	public:
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+
+			// Si hay hijo derecho, saltamos al primero
+			// en inorden del hijo derecho
+			if (_act->_dr)
+				_act = primeroInOrden(_act->_dr);
+			else {
+				// Si no, vamos al primer ascendiente
+				// no visitado.
+				if (_ascendientes.esVacia())
+					_act = NULL;
+				else {
+					_act = _ascendientes.cima();
+					_ascendientes.desapila();
+				}
+			}
+		}
+
+		const Clave &clave() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_clave;
+		}
+
+		const Valor &valor() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_valor;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusAgregado;
+
+		Iterador() : _act(NULL) {}
+		Iterador(Nodo *act) {
+			_act = primeroInOrden(act);
+		}
+
+		Nodo *primeroInOrden(Nodo *p) {
+			if (p == NULL)
+				return NULL;
+
+			while (p->_iz != NULL) {
+				_ascendientes.apila(p);
+				p = p->_iz;
+			}
+			return p;
+		}
+
+		// Puntero al nodo actual del recorrido
+		// NULL si hemos llegado al final.
+		Nodo *_act;
+
+		// Ascendientes del nodo actual
+		// an por visitar
+		Pila<Nodo*> _ascendientes;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(_ra);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador(NULL);
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbusAgregado(const ArbusAgregado<Clave, Valor, Monoide> &other) : _ra(NULL) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbusAgregado<Clave, Valor, Monoide> &operator=(const ArbusAgregado<Clave, Valor, Monoide> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	void libera() {
+		libera(_ra);
+	}
+
+	void copia(const ArbusAgregado &other) {
+		_ra = copiaAux(other._ra);
+	}
+
+private:
+
+	static void libera(Nodo *ra) {
+		if (ra != NULL) {
+			libera(ra->_iz);
+			libera(ra->_dr);
+			delete ra;
+		}
+	}
+
+	static Nodo *copiaAux(Nodo *ra) {
+		if (ra == NULL)
+			return NULL;
+
+		Nodo *ret = new Nodo(*ra);
+		ret->_iz = copiaAux(ra->_iz);
+		ret->_dr = copiaAux(ra->_dr);
+		return ret;
+	}
+
+	static Nodo *buscaAux(Nodo *p, const Clave &clave) {
+		while ((p != NULL) && !(p->_clave == clave))
+			p = (clave < p->_clave) ? p->_iz : p->_dr;
+		return p;
+	}
+
+	// //
+	// AGREGADOS
+	// //
+
+	static Valor agregado(Nodo *p) {
+		return p == NULL ? Monoide::neutro() : p->_agregado;
+	}
+
+	/**
+	 Agregado de las claves >= desde del subrbol p. Cada
+	 nodo del camino que queda dentro aporta su valor y su
+	 subrbol derecho completo, por delante de lo ya acumulado.
+	 */
+	static Valor agregadoDesde(Nodo *p, const Clave &desde) {
+		Valor ret = Monoide::neutro();
+		while (p != NULL) {
+			if (p->_clave < desde)
+				p = p->_dr;
+			else {
+				ret = Monoide::opera(Monoide::opera(p->_valor, agregado(p->_dr)), ret);
+				p = p->_iz;
+			}
+		}
+		return ret;
+	}
+
+	/**
+	 Agregado de las claves < hasta del subrbol p. Cada
+	 nodo del camino que queda dentro aporta su subrbol
+	 izquierdo completo y su valor, tras lo ya acumulado.
+	 */
+	static Valor agregadoHasta(Nodo *p, const Clave &hasta) {
+		Valor ret = Monoide::neutro();
+		while (p != NULL) {
+			if (p->_clave < hasta) {
+				ret = Monoide::opera(ret, Monoide::opera(agregado(p->_iz), p->_valor));
+				p = p->_dr;
+			} else
+				p = p->_iz;
+		}
+		return ret;
+	}
+
+	// //
+	// REEQUILIBRADO
+	// //
+
+	static int altura(Nodo *p) {
+		return p == NULL ? 0 : p->_altura;
+	}
+
+	/**
+	 Recalcula la altura y el agregado de un nodo a partir
+	 de los de sus hijos.
+	 */
+	static void actualiza(Nodo *p) {
+		int iz = altura(p->_iz);
+		int dr = altura(p->_dr);
+		p->_altura = 1 + (iz > dr ? iz : dr);
+		p->_agregado = Monoide::opera(
+			Monoide::opera(agregado(p->_iz), p->_valor), agregado(p->_dr));
+	}
+
+	static Nodo *rotaIz(Nodo *p) {
+		Nodo *dr = p->_dr;
+		p->_dr = dr->_iz;
+		actualiza(p);
+		dr->_iz = p;
+		actualiza(dr);
+		return dr;
+	}
+
+	static Nodo *rotaDr(Nodo *p) {
+		Nodo *iz = p->_iz;
+		p->_iz = iz->_dr;
+		actualiza(p);
+		iz->_dr = p;
+		actualiza(iz);
+		return iz;
+	}
+
+	/**
+	 Restablece la condicin AVL en p, cuyos hijos s la
+	 cumplen y cuyas alturas difieren a lo sumo en 2, y
+	 recalcula su altura y su agregado.
+	 @return Nueva raz del subrbol.
+	 */
+	static Nodo *equilibra(Nodo *p) {
+		int iz = altura(p->_iz);
+		int dr = altura(p->_dr);
+		if (iz > dr + 1) {
+			if (altura(p->_iz->_iz) < altura(p->_iz->_dr))
+				p->_iz = rotaIz(p->_iz);
+			return rotaDr(p);
+		} else if (dr > iz + 1) {
+			if (altura(p->_dr->_dr) < altura(p->_dr->_iz))
+				p->_dr = rotaDr(p->_dr);
+			return rotaIz(p);
+		}
+		actualiza(p);
+		return p;
+	}
+
+	// //
+	// INSERCIN Y BORRADO
+	// //
+
+	/**
+	 Inserta la pareja en el subrbol p; si la clave existe,
+	 sustituye su valor o, si acumular es true, lo combina
+	 con el nuevo.
+	 @return Nueva raz del subrbol.
+	 */
+	static Nodo *insertaAux(Nodo *p, const Clave &clave, const Valor &valor, bool acumular) {
+		if (p == NULL)
+			return new Nodo(clave, valor);
+
+		if (p->_clave == clave)
+			p->_valor = acumular ? Monoide::opera(p->_valor, valor) : valor;
+		else if (clave < p->_clave)
+			p->_iz = insertaAux(p->_iz, clave, valor, acumular);
+		else
+			p->_dr = insertaAux(p->_dr, clave, valor, acumular);
+		return equilibra(p);
+	}
+
+	/**
+	 Elimina (si existe) la clave del subrbol p.
+	 @return Nueva raz del subrbol.
+	 */
+	static Nodo *borraAux(Nodo *p, const Clave &clave) {
+		if (p == NULL)
+			return NULL;
+
+		if (clave < p->_clave)
+			p->_iz = borraAux(p->_iz, clave);
+		else if (p->_clave < clave)
+			p->_dr = borraAux(p->_dr, clave);
+		else {
+			Nodo *iz = p->_iz;
+			Nodo *dr = p->_dr;
+			delete p;
+			if (dr == NULL)
+				return iz;
+
+			// El mnimo del hijo derecho ocupa el
+			// lugar del nodo borrado
+			Nodo *min;
+			dr = quitaMin(dr, min);
+			min->_iz = iz;
+			min->_dr = dr;
+			return equilibra(min);
+		}
+		return equilibra(p);
+	}
+
+	/**
+	 Desengancha el nodo mnimo del subrbol p (no vaco),
+	 reequilibrando el camino.
+	 @param min Recibe el nodo desenganchado.
+	 @return Nueva raz del subrbol.
+	 */
+	static Nodo *quitaMin(Nodo *p, Nodo *&min) {
+		if (p->_iz == NULL) {
+			min = p;
+			return p->_dr;
+		}
+		p->_iz = quitaMin(p->_iz, min);
+		return equilibra(p);
+	}
+
+	/**
+	 Puntero a la raz de la estructura jerrquica
+	 de nodos.
+	 */
+	Nodo *_ra;
+};
+
+#endif // __ARBUSAGREGADO_H
@@ -0,0 +1,300 @@
+/**
+  @file ArbusCompacto.h
+
+  Implementacin del TAD Arbol de Bsqueda con los nodos
+  en un vector y los hijos direccionados por ndices de
+  32 bits.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSCOMPACTO_H
+#define __ARBUSCOMPACTO_H
+
+#include "Excepciones.h"
+
+#include "Pila.h" // Usado internamente por los iteradores
+
+#include "PoolIndices.h" // Almacn de los nodos
+
+/**
+ Variante de Arbus con la misma interfaz y el mismo
+ comportamiento (rbol de bsqueda sin equilibrar) pero
+ con otra representacin de los nodos: en lugar de
+ reservar cada nodo por separado con new y enlazarlos con
+ punteros de 64 bits, todos los nodos del rbol estn en
+ un PoolIndices y los hijos se identifican por su ndice
+ de 32 bits.
+
+ Para claves y valores pequeos (Arbus<int,int>) los
+ punteros son la mayor parte del nodo: cada nodo pasa de
+ 24 bytes ms la cabecera de new a 16 bytes, y los nodos
+ quedan juntos en memoria, lo que favorece a los recorridos.
+ Adems, copiar el rbol es copiar el vector, sin recorrer
+ la estructura, y destruirlo es liberar el vector.
+
+ Como los nodos pueden cambiar de sitio cuando el vector
+ crece, las referencias devueltas por consulta y por los
+ iteradores dejan de ser vlidas al insertar. El rbol
+ admite como mucho 2^31 - 1 nodos. Clave y Valor deben
+ tener constructor sin parmetros.
+ */
+template <class Clave, class Valor>
+class ArbusCompacto {
+private:
+	/** ndice de 32 bits de un nodo en el almacn. */
+	typedef unsigned int Indice;
+
+	/**
+	 Clase nodo que almacena internamente la pareja (clave, valor)
+	 y los ndices del hijo izquierdo y del hijo derecho.
+	 */
+	class Nodo {
+	public:
+		Nodo() : _iz(NULO), _dr(NULO) {}
+		Nodo(const Clave &clave, const Valor &valor)
+			: _clave(clave), _valor(valor), _iz(NULO), _dr(NULO) {}
+
+		Clave _clave;
+		Valor _valor;
+		Indice _iz;
+		Indice _dr;
+	};
+
+	enum { NULO = PoolIndices<Nodo>::NULO };
+
+public:
+
+	/** Constructor; operacion ArbolVacio */
+	ArbusCompacto() : _ra(NULO) {
+	}
+
+	/**
+	 Operacin generadora que aade una nueva clave/valor
+	 a un rbol de bsqueda.
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave. Si la clave
+	 ya se haba insertado previamente, sustituimos el valor
+	 viejo por el nuevo.
+	 */
+	void inserta(const Clave &clave, const Valor &valor) {
+		Indice padre = NULO;
+		Indice p = _ra;
+		while (p != NULO) {
+			Nodo &n = _nodos[p];
+			if (n._clave == clave) {
+				n._valor = valor;
+				return;
+			}
+			padre = p;
+			p = (clave < n._clave) ? n._iz : n._dr;
+		}
+
+		// La reserva puede mover los nodos: se enlaza el
+		// nuevo volviendo a acceder al padre por su ndice
+		Indice nuevo = _nodos.reserva(Nodo(clave, valor));
+		if (padre == NULO)
+			_ra = nuevo;
+		else if (clave < _nodos[padre]._clave)
+			_nodos[padre]._iz = nuevo;
+		else
+			_nodos[padre]._dr = nuevo;
+	}
+
+	/**
+	 Operacin modificadora que elimina una clave del rbol.
+	 Si la clave no exista la operacin no tiene efecto.
+	 @param clave Clave a eliminar.
+	 */
+	void borra(const Clave &clave) {
+		Indice padre = NULO;
+		Indice p = _ra;
+		while ((p != NULO) && !(_nodos[p]._clave == clave)) {
+			padre = p;
+			p = (clave < _nodos[p]._clave) ? _nodos[p]._iz : _nodos[p]._dr;
+		}
+		if (p == NULO)
+			return;
+
+		Indice sustituto = borraRaiz(p);
+		if (padre == NULO)
+			_ra = sustituto;
+		else if (_nodos[padre]._iz == p)
+			_nodos[padre]._iz = sustituto;
+		else
+			_nodos[padre]._dr = sustituto;
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada. Es un error preguntar por una clave
+	 que no existe.
+	 @param clave Clave por la que se pregunta.
+	 */
+	const Valor &consulta(const Clave &clave) const {
+		Indice p = buscaAux(clave);
+		if (p == NULO)
+			throw EClaveErronea();
+
+		return _nodos[p]._valor;
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el rbol de bsqueda.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) const {
+		return buscaAux(clave) != NULO;
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _ra == NULO;
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Clase interna que implementa un iterador que
+	 recorre las claves del rbol en orden.
+	 */
+	class Iterador {
+	public:
+		void avanza() {
+			if (_act == NULO) throw EAccesoInvalido();
+
+			// Si hay hijo derecho, saltamos al primero
+			// en inorden del hijo derecho
+			if ((*_nodos)[_act]._dr != NULO)
+				_act = primeroInOrden((*_nodos)[_act]._dr);
+			else {
+				// Si no, vamos al primer ascendiente
+				// no visitado.
+				if (_ascendientes.esVacia())
+					_act = NULO;
+				else {
+					_act = _ascendientes.cima();
+					_ascendientes.desapila();
+				}
+			}
+		}
+
+		const Clave &clave() const {
+			if (_act == NULO) throw EAccesoInvalido();
+			return (*_nodos)[_act]._clave;
+		}
+
+		const Valor &valor() const {
+			if (_act == NULO) throw EAccesoInvalido();
+			return (*_nodos)[_act]._valor;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusCompacto;
+
+		Iterador(const PoolIndices<Nodo> *nodos, Indice act) : _nodos(nodos) {
+			_act = primeroInOrden(act);
+		}
+
+		Indice primeroInOrden(Indice p) {
+			if (p == NULO)
+				return NULO;
+
+			while ((*_nodos)[p]._iz != NULO) {
+				_ascendientes.apila(p);
+				p = (*_nodos)[p]._iz;
+			}
+			return p;
+		}
+
+		// Almacn de los nodos del rbol recorrido
+		const PoolIndices<Nodo> *_nodos;
+
+		// ndice del nodo actual del recorrido
+		// NULO si hemos llegado al final.
+		Indice _act;
+
+		// Ascendientes del nodo actual
+		// an por visitar
+		Pila<Indice> _ascendientes;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(&_nodos, _ra);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador(&_nodos, NULO);
+	}
+
+	// La copia, la asignacin y la destruccin son las
+	// del almacn de nodos: se copia o libera el vector
+	// completo, sin recorrer el rbol.
+
+private:
+
+	Indice buscaAux(const Clave &clave) const {
+		Indice p = _ra;
+		while ((p != NULO) && !(_nodos[p]._clave == clave))
+			p = (clave < _nodos[p]._clave) ? _nodos[p]._iz : _nodos[p]._dr;
+		return p;
+	}
+
+	/**
+	 Borra el nodo p y devuelve el ndice del nodo que
+	 debe ocupar su lugar: uno de sus hijos si slo tiene
+	 uno o, si tiene dos, el mnimo de su hijo derecho, que
+	 se desengancha de su sitio.
+	 */
+	Indice borraRaiz(Indice p) {
+		Indice ret;
+		if (_nodos[p]._iz == NULO)
+			ret = _nodos[p]._dr;
+		else if (_nodos[p]._dr == NULO)
+			ret = _nodos[p]._iz;
+		else {
+			Indice padre = NULO;
+			ret = _nodos[p]._dr;
+			while (_nodos[ret]._iz != NULO) {
+				padre = ret;
+				ret = _nodos[ret]._iz;
+			}
+			if (padre != NULO) {
+				_nodos[padre]._iz = _nodos[ret]._dr;
+				_nodos[ret]._dr = _nodos[p]._dr;
+			}
+			_nodos[ret]._iz = _nodos[p]._iz;
+		}
+		_nodos.devuelve(p);
+		return ret;
+	}
+
+	/** Almacn con todos los nodos del rbol. */
+	PoolIndices<Nodo> _nodos;
+
+	/** ndice de la raz; NULO si el rbol es vaco. */
+	Indice _ra;
+};
+
+#endif // __ARBUSCOMPACTO_H
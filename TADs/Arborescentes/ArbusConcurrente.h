@@ -0,0 +1,602 @@
+/**
+  @file ArbusConcurrente.h
+
+  Implementacin concurrente del TAD Arbol de Bsqueda
+  mediante una skip list con bloqueo perezoso (lazy
+  skip list).
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSCONCURRENTE_H
+#define __ARBUSCONCURRENTE_H
+
+#include "Excepciones.h"
+
+#include "Pila.h" // Nodos pendientes de liberar
+
+#include <atomic>
+#include <mutex>
+
+/**
+ Implementacin del TAD Arbus que pueden usar varios hilos
+ a la vez, tanto para modificarlo como para consultarlo y
+ recorrerlo. Internamente es una skip list "perezosa"
+ (Herlihy, Lev, Luchangco y Shavit):
+
+ - Las bsquedas (consulta, esta) y los recorridos no
+ adquieren ningn cerrojo.
+
+ - inserta y borra bloquean nicamente los predecesores
+ del nodo afectado en cada nivel, de modo que hilos que
+ trabajan en zonas distintas de la lista no se esperan.
+ El borrado es en dos pasos: primero se marca el nodo
+ (borrado lgico) y luego se desenlaza (borrado fsico).
+
+ - Los nodos desenlazados no se liberan inmediatamente,
+ pues otro hilo podra estar leyndolos. Se usa un esquema
+ de reclamacin por pocas: cada operacin (y cada iterador
+ mientras vive) se registra en la poca actual; los nodos
+ retirados en una poca se liberan cuando ya no queda ningn
+ hilo registrado en ella ni en las anteriores.
+
+ - Los iteradores son dbilmente consistentes: recorren
+ las claves en orden, nunca devuelven una clave dos veces
+ ni fallan por modificaciones concurrentes, y reflejan
+ algunas (no necesariamente todas) las modificaciones
+ hechas despus de crearlos. Un iterador vivo retrasa la
+ liberacin de los nodos borrados, por lo que no conviene
+ mantenerlos indefinidamente.
+
+ A diferencia de Arbus, consulta y el valor() del iterador
+ devuelven el valor por copia (otro hilo podra sustituirlo
+ mientras tanto) y el rbol no se puede copiar. La clave
+ debe tener definidos == y <, igual que en Arbus.
+ */
+template <class Clave, class Valor>
+class ArbusConcurrente {
+public:
+
+	/**
+	 Nmero mximo de niveles de la skip list. Con
+	 probabilidad 1/2 de subir de nivel, es adecuado
+	 para unos 2^NIVEL_MAX elementos.
+	 */
+	enum { NIVEL_MAX = 24 };
+
+	/**
+	 Nmero de nodos retirados tras el cual se intenta
+	 avanzar de poca (y liberar nodos).
+	 */
+	enum { UMBRAL_RECLAMACION = 64 };
+
+private:
+	/**
+	 Clase nodo de la skip list. Guarda la pareja (clave, valor),
+	 un vector de punteros al siguiente en cada uno de sus
+	 niveles, las marcas de borrado lgico y de nodo
+	 completamente enlazado, y el cerrojo del nodo.
+	 */
+	class Nodo {
+	public:
+		Nodo(int nivel) : _nivel(nivel), _marcado(false), _enlazado(false) {
+			_sig = new std::atomic<Nodo*>[nivel + 1];
+			for (int i = 0; i <= nivel; ++i)
+				_sig[i] = NULL;
+		}
+		Nodo(const Clave &clave, const Valor &valor, int nivel)
+			: _clave(clave), _valor(valor), _nivel(nivel),
+			  _marcado(false), _enlazado(false) {
+			_sig = new std::atomic<Nodo*>[nivel + 1];
+			for (int i = 0; i <= nivel; ++i)
+				_sig[i] = NULL;
+		}
+		~Nodo() {
+			delete []_sig;
+		}
+
+		Clave _clave;
+		Valor _valor;
+		std::atomic<Nodo*> *_sig;
+		int _nivel;
+		std::atomic<bool> _marcado;
+		std::atomic<bool> _enlazado;
+		std::mutex _cerrojo;
+	};
+
+	/**
+	 Registro de un hilo en la poca actual mientras
+	 dura una operacin. Mientras exista, ningn nodo
+	 que pudiera estar viendo ese hilo se libera.
+	 */
+	class Guarda {
+	public:
+		Guarda(const ArbusConcurrente *arbol) : _arbol(arbol) {
+			_epoca = _arbol->entra();
+		}
+		~Guarda() {
+			_arbol->sale(_epoca);
+		}
+	private:
+		Guarda(const Guarda &);
+		Guarda &operator=(const Guarda &);
+
+		const ArbusConcurrente *_arbol;
+		unsigned long long _epoca;
+	};
+
+public:
+
+	/** Constructor; operacion ArbolVacio */
+	ArbusConcurrente() : _epoca(0), _numRetirados(0) {
+		_cabeza = new Nodo(NIVEL_MAX - 1);
+		_activos[0] = 0;
+		_activos[1] = 0;
+		_cabeza->_enlazado = true;
+	}
+
+	/**
+	 Destructor; libera todos los nodos. No puede haber
+	 otros hilos usando el rbol ni iteradores vivos.
+	 */
+	~ArbusConcurrente() {
+		Nodo *p = _cabeza;
+		while (p != NULL) {
+			Nodo *sig = p->_sig[0];
+			delete p;
+			p = sig;
+		}
+		for (int i = 0; i < 3; ++i)
+			liberaRetirados(i);
+	}
+
+	/**
+	 Operacin generadora que aade una nueva clave/valor
+	 al rbol. Puede llamarse desde varios hilos a la vez.
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave. Si la clave
+	 ya se haba insertado previamente, sustituimos el valor
+	 viejo por el nuevo.
+
+	 El nodo nuevo (y la copia de clave y valor, que pueden
+	 lanzar excepciones) se crea antes de bloquear ningn
+	 predecesor; si aun as algo falla con predecesores
+	 bloqueados, se desbloquean antes de propagar la
+	 excepcin.
+	 */
+	void inserta(const Clave &clave, const Valor &valor) {
+		Guarda guarda(this);
+		int nivel = nivelAleatorio();
+		Nodo *preds[NIVEL_MAX];
+		Nodo *sigs[NIVEL_MAX];
+		Nodo *nuevo = NULL;
+		int bloqueados = -1;
+
+		try {
+			while (true) {
+				int encontrado = busca(clave, preds, sigs);
+				if (encontrado != -1) {
+					Nodo *p = sigs[encontrado];
+					if (!p->_marcado) {
+						// Ya est: esperamos a que termine de
+						// enlazarse y sustituimos el valor, salvo
+						// que otro hilo lo borre entretanto
+						while (!p->_enlazado)
+							;
+						std::lock_guard<std::mutex> cerrojo(p->_cerrojo);
+						if (!p->_marcado) {
+							p->_valor = valor;
+							delete nuevo;
+							return;
+						}
+					}
+					// Se est borrando; reintentamos
+					continue;
+				}
+
+				if (nuevo == NULL)
+					nuevo = new Nodo(clave, valor, nivel);
+
+				// Bloqueamos los predecesores de abajo a arriba
+				// y comprobamos que siguen enlazados a sus
+				// sucesores y que ninguno se est borrando
+				bool valido = true;
+				for (int i = 0; valido && (i <= nivel); ++i) {
+					if ((i == 0) || (preds[i] != preds[i - 1])) {
+						preds[i]->_cerrojo.lock();
+						bloqueados = i;
+					}
+					valido = !preds[i]->_marcado &&
+						((sigs[i] == NULL) || !sigs[i]->_marcado) &&
+						(preds[i]->_sig[i] == sigs[i]);
+				}
+
+				if (valido) {
+					for (int i = 0; i <= nivel; ++i)
+						nuevo->_sig[i] = sigs[i];
+					for (int i = 0; i <= nivel; ++i)
+						preds[i]->_sig[i] = nuevo;
+					nuevo->_enlazado = true;
+				}
+
+				desbloquea(preds, bloqueados);
+				bloqueados = -1;
+				if (valido)
+					return;
+			}
+		} catch (...) {
+			desbloquea(preds, bloqueados);
+			delete nuevo;
+			throw;
+		}
+	}
+
+	/**
+	 Operacin modificadora que elimina una clave del rbol.
+	 Si la clave no exista la operacin no tiene efecto.
+	 Puede llamarse desde varios hilos a la vez.
+	 @param clave Clave a eliminar.
+	 */
+	void borra(const Clave &clave) {
+		Guarda guarda(this);
+		Nodo *preds[NIVEL_MAX];
+		Nodo *sigs[NIVEL_MAX];
+		Nodo *victima = NULL;
+		bool marcado = false;
+
+		while (true) {
+			int encontrado = busca(clave, preds, sigs);
+
+			if (!marcado) {
+				// Slo se puede borrar un nodo completamente
+				// enlazado, encontrado en su nivel ms alto
+				// y que nadie est borrando ya
+				if ((encontrado == -1) ||
+					!sigs[encontrado]->_enlazado ||
+					(sigs[encontrado]->_nivel != encontrado) ||
+					sigs[encontrado]->_marcado)
+					return;
+
+				victima = sigs[encontrado];
+				victima->_cerrojo.lock();
+				if (victima->_marcado) {
+					victima->_cerrojo.unlock();
+					return;
+				}
+				// Borrado lgico
+				victima->_marcado = true;
+				marcado = true;
+			}
+
+			int bloqueados = -1;
+			bool valido = true;
+			for (int i = 0; valido && (i <= victima->_nivel); ++i) {
+				if ((i == 0) || (preds[i] != preds[i - 1])) {
+					preds[i]->_cerrojo.lock();
+					bloqueados = i;
+				}
+				valido = !preds[i]->_marcado && (preds[i]->_sig[i] == victima);
+			}
+
+			if (valido) {
+				// Borrado fsico, de arriba a abajo
+				for (int i = victima->_nivel; i >= 0; --i)
+					preds[i]->_sig[i] = victima->_sig[i].load();
+				victima->_cerrojo.unlock();
+			}
+
+			desbloquea(preds, bloqueados);
+			if (valido) {
+				retira(victima);
+				return;
+			}
+		}
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada. Es un error preguntar por una clave
+	 que no existe.
+	 @param clave Clave por la que se pregunta.
+	 @return Copia del valor asociado.
+	 */
+	Valor consulta(const Clave &clave) const {
+		Guarda guarda(this);
+		Nodo *p = buscaNodo(clave);
+		if (p == NULL)
+			throw EClaveErronea();
+
+		std::lock_guard<std::mutex> cerrojo(p->_cerrojo);
+		return p->_valor;
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el rbol. No bloquea.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) const {
+		Guarda guarda(this);
+		return buscaNodo(clave) != NULL;
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return principio() == final();
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Clase interna que implementa un iterador dbilmente
+	 consistente que recorre las claves en orden. Mientras
+	 el iterador existe mantiene registrada su poca, por
+	 lo que los nodos que visita no se liberan.
+	 */
+	class Iterador {
+	public:
+		~Iterador() {
+			sal();
+		}
+
+		Iterador(const Iterador &other) : _arbol(NULL) {
+			copia(other);
+		}
+
+		Iterador &operator=(const Iterador &other) {
+			if (this != &other) {
+				sal();
+				copia(other);
+			}
+			return *this;
+		}
+
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+			_act = siguienteVivo(_act->_sig[0]);
+		}
+
+		const Clave &clave() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_clave;
+		}
+
+		Valor valor() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			std::lock_guard<std::mutex> cerrojo(_act->_cerrojo);
+			return _act->_valor;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusConcurrente;
+
+		Iterador() : _arbol(NULL), _act(NULL) {}
+		Iterador(const ArbusConcurrente *arbol) : _arbol(arbol) {
+			_epoca = _arbol->entra();
+			_act = siguienteVivo(_arbol->_cabeza->_sig[0]);
+		}
+
+		/** Salta los nodos que se estn borrando. */
+		static Nodo *siguienteVivo(Nodo *p) {
+			while ((p != NULL) && (p->_marcado || !p->_enlazado))
+				p = p->_sig[0];
+			return p;
+		}
+
+		void copia(const Iterador &other) {
+			_arbol = other._arbol;
+			_epoca = other._epoca;
+			_act = other._act;
+			// Mientras other siga registrado en su poca,
+			// sta no puede haberse cerrado
+			if (_arbol != NULL)
+				_arbol->reentra(_epoca);
+		}
+
+		void sal() {
+			if (_arbol != NULL)
+				_arbol->sale(_epoca);
+			_arbol = NULL;
+		}
+
+		// rbol recorrido (NULL si el iterador no
+		// est registrado en ninguna poca)
+		const ArbusConcurrente *_arbol;
+
+		// poca en la que est registrado el iterador
+		unsigned long long _epoca;
+
+		// Puntero al nodo actual del recorrido
+		// NULL si hemos llegado al final.
+		Nodo *_act;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(this);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador();
+	}
+
+private:
+
+	// El rbol no se puede copiar
+	ArbusConcurrente(const ArbusConcurrente &);
+	ArbusConcurrente &operator=(const ArbusConcurrente &);
+
+	/**
+	 Busca la clave en todos los niveles, de arriba a
+	 abajo, rellenando en cada nivel el ltimo nodo con
+	 clave menor (preds) y el siguiente a l (sigs; NULL
+	 si es el final).
+	 @return Nivel ms alto en el que se encontr la clave,
+	 o -1 si no est.
+	 */
+	int busca(const Clave &clave, Nodo **preds, Nodo **sigs) const {
+		int encontrado = -1;
+		Nodo *pred = _cabeza;
+		for (int i = NIVEL_MAX - 1; i >= 0; --i) {
+			Nodo *act = pred->_sig[i];
+			while ((act != NULL) && (act->_clave < clave)) {
+				pred = act;
+				act = pred->_sig[i];
+			}
+			if ((encontrado == -1) && (act != NULL) && (act->_clave == clave))
+				encontrado = i;
+			preds[i] = pred;
+			sigs[i] = act;
+		}
+		return encontrado;
+	}
+
+	/**
+	 Busca sin bloquear el nodo con la clave, que debe
+	 estar completamente enlazado y no borrado.
+	 */
+	Nodo *buscaNodo(const Clave &clave) const {
+		Nodo *pred = _cabeza;
+		for (int i = NIVEL_MAX - 1; i >= 0; --i) {
+			Nodo *act = pred->_sig[i];
+			while ((act != NULL) && (act->_clave < clave)) {
+				pred = act;
+				act = pred->_sig[i];
+			}
+			if ((act != NULL) && (act->_clave == clave))
+				return (act->_enlazado && !act->_marcado) ? act : NULL;
+		}
+		return NULL;
+	}
+
+	/**
+	 Libera los cerrojos de los predecesores de los niveles
+	 0 a hasta, teniendo en cuenta que un mismo nodo puede
+	 ser predecesor en varios niveles consecutivos.
+	 */
+	static void desbloquea(Nodo **preds, int hasta) {
+		for (int i = 0; i <= hasta; ++i)
+			if ((i == 0) || (preds[i] != preds[i - 1]))
+				preds[i]->_cerrojo.unlock();
+	}
+
+	/**
+	 Nivel (0 a NIVEL_MAX - 1) de un nodo nuevo; cada nivel
+	 tiene la mitad de probabilidad que el anterior.
+	 */
+	static int nivelAleatorio() {
+		static thread_local unsigned int semilla = 0;
+		if (semilla == 0)
+			semilla = 2463534242u ^ (unsigned int)(size_t)&semilla;
+		semilla ^= semilla << 13;
+		semilla ^= semilla >> 17;
+		semilla ^= semilla << 5;
+
+		int nivel = 0;
+		unsigned int bits = semilla;
+		while ((bits & 1) && (nivel < NIVEL_MAX - 1)) {
+			++nivel;
+			bits >>= 1;
+		}
+		return nivel;
+	}
+
+	// //
+	// RECLAMACIN DE MEMORIA POR POCAS
+	// //
+
+	/**
+	 Registra al hilo en la poca actual. Si la poca cambia
+	 mientras se registra, se vuelve a intentar, de modo que
+	 al terminar el hilo est contado en la poca vigente.
+	 @return poca en la que ha quedado registrado.
+	 */
+	unsigned long long entra() const {
+		while (true) {
+			unsigned long long e = _epoca;
+			++_activos[e % 2];
+			if (_epoca == e)
+				return e;
+			--_activos[e % 2];
+		}
+	}
+
+	/** Registra de nuevo en una poca que sigue abierta. */
+	void reentra(unsigned long long e) const {
+		++_activos[e % 2];
+	}
+
+	void sale(unsigned long long e) const {
+		--_activos[e % 2];
+	}
+
+	/**
+	 Retira un nodo ya desenlazado: se guarda junto con la
+	 poca actual y se libera ms adelante, cuando ningn
+	 hilo pueda tenerlo.
+	 */
+	void retira(Nodo *p) {
+		std::lock_guard<std::mutex> cerrojo(_cerrojoRetirados);
+		_retirados[_epoca % 3].apila(p);
+		if (++_numRetirados % UMBRAL_RECLAMACION == 0)
+			intentaAvanzar();
+	}
+
+	/**
+	 Pasa de la poca e a la e + 1 si no queda nadie
+	 registrado en la e - 1. Tras el cambio slo puede haber
+	 hilos en e y e + 1, que empezaron despus de que se
+	 desenlazaran los nodos retirados en e - 1, as que stos
+	 ya se pueden liberar. Se llama con _cerrojoRetirados
+	 adquirido.
+	 */
+	void intentaAvanzar() {
+		unsigned long long e = _epoca;
+		if (_activos[(e + 1) % 2] != 0)
+			return;
+		_epoca = e + 1;
+		liberaRetirados((e + 2) % 3);
+	}
+
+	void liberaRetirados(int i) {
+		while (!_retirados[i].esVacia()) {
+			delete _retirados[i].cima();
+			_retirados[i].desapila();
+		}
+	}
+
+	/** Nodo cabecera; su clave no se usa nunca. */
+	Nodo *_cabeza;
+
+	/** poca actual. */
+	std::atomic<unsigned long long> _epoca;
+
+	/** Hilos registrados en las pocas pares e impares. */
+	mutable std::atomic<int> _activos[2];
+
+	/** Nodos retirados en cada poca (mdulo 3). */
+	Pila<Nodo*> _retirados[3];
+	unsigned int _numRetirados;
+	std::mutex _cerrojoRetirados;
+};
+
+#endif // __ARBUSCONCURRENTE_H
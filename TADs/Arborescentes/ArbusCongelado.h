@@ -0,0 +1,330 @@
+/**
+  @file ArbusCongelado.h
+
+  Diccionario ordenado inmutable con disposicin de
+  Eytzinger, obtenido al congelar un Arbus.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSCONGELADO_H
+#define __ARBUSCONGELADO_H
+
+#include "Excepciones.h"
+
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <xmmintrin.h>
+#endif
+
+/**
+ Diccionario ordenado de slo lectura. Se construye una
+ vez (normalmente con Arbus::congela()) y a partir de ah
+ slo se consulta.
+
+ Las claves se guardan en un vector con la disposicin de
+ Eytzinger: el rbol de bsqueda perfectamente equilibrado
+ se almacena por niveles, como un montculo, de modo que
+ los hijos del elemento k estn en 2k y 2k+1 (la posicin 0
+ no se usa). Comparado con los nodos sueltos de Arbus:
+
+ - No hay punteros: el vector ocupa n claves y n valores
+   contiguos, y los primeros niveles del rbol (los que
+   recorren todas las bsquedas) comparten unas pocas
+   lneas de cach.
+ - La bsqueda no tiene saltos condicionales en funcin
+   de la clave: k = 2k + (clave[k] < buscada). El
+   procesador no falla predicciones y, como la direccin
+   de los 16 descendientes de k cuatro niveles ms abajo es
+   conocida (16k..16k+15), se solicitan a memoria mientras
+   se hacen las comparaciones intermedias.
+
+ Los valores se guardan en un vector paralelo al de
+ claves, para que la bsqueda slo toque claves.
+ Clave y Valor deben tener constructor sin parmetros.
+ */
+template <class Clave, class Valor>
+class ArbusCongelado {
+public:
+
+	/** Constructor; diccionario vaco. */
+	ArbusCongelado() : _claves(NULL), _valores(NULL), _n(0) {
+	}
+
+	/**
+	 Construye el diccionario a partir de un recorrido en
+	 orden de n claves distintas. El iterador ha de ofrecer
+	 clave(), valor() y avanza(), como los de Arbus.
+	 O(n).
+	 @param it Iterador al comienzo del recorrido.
+	 @param n Nmero de elementos a tomar del recorrido.
+	 */
+	template <class It>
+	ArbusCongelado(It it, std::size_t n) : _n(n) {
+		_claves = new Clave[n + 1];
+		_valores = new Valor[n + 1];
+
+		// Visitamos las posiciones del vector en inorden;
+		// la i-sima visitada recibe el i-simo elemento
+		for (std::size_t k = primera(); k != 0; k = siguiente(k)) {
+			_claves[k] = it.clave();
+			_valores[k] = it.valor();
+			it.avanza();
+		}
+	}
+
+	/** Destructor */
+	~ArbusCongelado() {
+		libera();
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada. Es un error preguntar por una clave
+	 que no existe.
+	 @param clave Clave por la que se pregunta.
+	 */
+	const Valor &consulta(const Clave &clave) const {
+		std::size_t k = cotaInferior(clave);
+		if ((k == 0) || (clave < _claves[k]))
+			throw EClaveErronea();
+
+		return _valores[k];
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el diccionario.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) const {
+		std::size_t k = cotaInferior(clave);
+		return (k != 0) && !(clave < _claves[k]);
+	}
+
+	/**
+	 Operacin observadora que devuelve si el diccionario
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _n == 0;
+	}
+
+	/** Nmero de elementos del diccionario. */
+	std::size_t numElems() const {
+		return _n;
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Iterador que recorre las claves en orden. Basta
+	 con la posicin actual: el sucesor en inorden de k se
+	 calcula a partir de k, sin necesidad de pila.
+	 */
+	class Iterador {
+	public:
+		void avanza() {
+			if (_pos == 0) throw EAccesoInvalido();
+			_pos = _dic->siguiente(_pos);
+		}
+
+		const Clave &clave() const {
+			if (_pos == 0) throw EAccesoInvalido();
+			return _dic->_claves[_pos];
+		}
+
+		const Valor &valor() const {
+			if (_pos == 0) throw EAccesoInvalido();
+			return _dic->_valores[_pos];
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _pos == other._pos;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusCongelado;
+
+		Iterador(const ArbusCongelado *dic, std::size_t pos) : _dic(dic), _pos(pos) {}
+
+		const ArbusCongelado *_dic;
+
+		// Posicin actual en el vector; 0 al final
+		std::size_t _pos;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(this, primera());
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador(this, 0);
+	}
+
+	/**
+	 Devuelve un iterador a la primera clave que es
+	 mayor o igual que la dada (cota inferior).
+	 @param clave Clave desde la que empezar el recorrido.
+	 @return Iterador a la primera clave >= clave; final()
+	 si no hay ninguna.
+	 */
+	Iterador buscaDesde(const Clave &clave) const {
+		return Iterador(this, cotaInferior(clave));
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbusCongelado(const ArbusCongelado<Clave, Valor> &other) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbusCongelado<Clave, Valor> &operator=(const ArbusCongelado<Clave, Valor> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	void libera() {
+		delete []_claves;
+		delete []_valores;
+		_claves = NULL;
+		_valores = NULL;
+		_n = 0;
+	}
+
+	void copia(const ArbusCongelado &other) {
+		_n = other._n;
+		_claves = new Clave[_n + 1];
+		_valores = new Valor[_n + 1];
+		for (std::size_t k = 1; k <= _n; ++k) {
+			_claves[k] = other._claves[k];
+			_valores[k] = other._valores[k];
+		}
+	}
+
+private:
+
+	/**
+	 Nmero de elementos por delante de k a los que se
+	 adelanta la precarga: los descendientes de k cuatro
+	 niveles ms abajo.
+	 */
+	enum { DISTANCIA_PRECARGA = 16 };
+
+	/**
+	 Pide a la memoria la lnea de cach de la direccin
+	 dada sin esperar por ella. Es slo una pista: no falla
+	 aunque la direccin quede fuera del vector.
+	 */
+	static void precarga(const void *dir) {
+#if defined(__GNUC__)
+		__builtin_prefetch(dir);
+#elif defined(_MSC_VER)
+		_mm_prefetch(static_cast<const char*>(dir), _MM_HINT_T0);
+#else
+		(void)dir;
+#endif
+	}
+
+	/**
+	 Nmero de ceros menos significativos de x (x != 0).
+	 */
+	static unsigned int cerosFinales(std::size_t x) {
+#if defined(__GNUC__)
+		return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_WIN64)
+		unsigned long pos;
+		_BitScanForward64(&pos, x);
+		return pos;
+#else
+		unsigned int ret = 0;
+		while ((x & 1) == 0) {
+			x >>= 1;
+			++ret;
+		}
+		return ret;
+#endif
+	}
+
+	/**
+	 Posicin de la primera clave mayor o igual que la dada,
+	 o 0 si no hay ninguna. El descenso siempre llega hasta
+	 el fondo del rbol: cada paso aade a k un bit, que es 1
+	 si se ha bajado por la derecha. La respuesta es el ltimo
+	 nodo en el que se baj por la izquierda, as que basta con
+	 quitar de k los unos finales y el cero que los precede.
+	 */
+	std::size_t cotaInferior(const Clave &clave) const {
+		std::size_t k = 1;
+		while (k <= _n) {
+			precarga(reinterpret_cast<const char*>(_claves) +
+					 k * DISTANCIA_PRECARGA * sizeof(Clave));
+			k = 2 * k + (_claves[k] < clave);
+		}
+		return k >> (cerosFinales(~k) + 1);
+	}
+
+	/** Primera posicin en inorden (0 si es vaco). */
+	std::size_t primera() const {
+		if (_n == 0)
+			return 0;
+		std::size_t k = 1;
+		while (2 * k <= _n)
+			k = 2 * k;
+		return k;
+	}
+
+	/**
+	 Siguiente posicin en inorden tras k; 0 si k es la
+	 ltima. Si k tiene hijo derecho, el sucesor es el primero
+	 de ese subrbol; si no, se sube mientras k sea hijo
+	 derecho y el sucesor es el padre.
+	 */
+	std::size_t siguiente(std::size_t k) const {
+		if (2 * k + 1 <= _n) {
+			k = 2 * k + 1;
+			while (2 * k <= _n)
+				k = 2 * k;
+			return k;
+		}
+		while (k & 1)
+			k >>= 1;
+		return k >> 1;
+	}
+
+	/** Claves en disposicin de Eytzinger (desde la 1). */
+	Clave *_claves;
+
+	/** Valores, en las mismas posiciones que sus claves. */
+	Valor *_valores;
+
+	/** Nmero de elementos. */
+	std::size_t _n;
+};
+
+#endif // __ARBUSCONGELADO_H
@@ -0,0 +1,437 @@
+/**
+  @file ArbusPersistente.h
+
+  Implementacin persistente del TAD Arbol de Bsqueda,
+  con copia de caminos y comparticin de estructura.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSPERSISTENTE_H
+#define __ARBUSPERSISTENTE_H
+
+#include "Excepciones.h"
+
+#include "Pila.h" // Usado internamente por los iteradores
+
+#include <cassert>
+
+/**
+ Implementacin persistente del TAD Arbus. Los nodos no
+ se modifican nunca una vez creados: inserta y borra
+ construyen nodos nuevos para el camino desde la raz
+ hasta la clave afectada (copia de caminos) y comparten
+ con la versin anterior todo lo dems. El rbol est
+ equilibrado (AVL, con tolerancia 2 en la diferencia de
+ alturas), por lo que cada modificacin crea O(log n)
+ nodos.
+
+ Igual que en Arbin, la estructura compartida se mantiene
+ bajo control mediante conteo de referencias en los nodos
+ (addRef/remRef). Gracias a ello copiar un rbol (constructor
+ copia u operador de asignacin) es O(1): slo se comparte
+ la raz. Un lector que quiera una versin consistente
+ mientras otro cdigo sigue modificando el rbol no tiene
+ ms que quedarse con una copia; las modificaciones
+ posteriores no le afectan.
+
+ Al igual que en Arbin, el contador de referencias no es
+ atmico: las copias no deben manipularse desde varios
+ hilos a la vez.
+
+ Las operaciones (inserta, borra, consulta, esta, esVacio
+ e iteradores) se comportan igual que en Arbus.
+ */
+template <class Clave, class Valor>
+class ArbusPersistente {
+private:
+	/**
+	 Clase nodo que almacena internamente la pareja (clave, valor),
+	 los punteros a los hijos, la altura del subrbol y el
+	 nmero de referencias que hay al nodo.
+	 */
+	class Nodo {
+	public:
+		Nodo(Nodo *iz, const Clave &clave, const Valor &valor, Nodo *dr)
+			: _clave(clave), _valor(valor), _iz(iz), _dr(dr), _numRefs(0) {
+			if (_iz != NULL)
+				_iz->addRef();
+			if (_dr != NULL)
+				_dr->addRef();
+			int hiz = altura(_iz), hdr = altura(_dr);
+			_altura = 1 + (hiz > hdr ? hiz : hdr);
+		}
+
+		void addRef() { assert(_numRefs >= 0); _numRefs++; }
+		void remRef() { assert(_numRefs > 0); _numRefs--; }
+
+		const Clave _clave;
+		const Valor _valor;
+		Nodo * const _iz;
+		Nodo * const _dr;
+		int _altura;
+
+		int _numRefs;
+	};
+
+public:
+
+	/** Constructor; operacion ArbolVacio */
+	ArbusPersistente() : _ra(NULL) {
+	}
+
+	/** Destructor; libera la estructura que no se comparta. */
+	~ArbusPersistente() {
+		libera();
+		_ra = NULL;
+	}
+
+	/**
+	 Operacin generadora que aade una nueva clave/valor
+	 a un rbol de bsqueda. Las copias previas del rbol
+	 no ven el cambio.
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave. Si la clave
+	 ya se haba insertado previamente, sustituimos el valor
+	 viejo por el nuevo.
+	 */
+	void inserta(const Clave &clave, const Valor &valor) {
+		cambiaRaiz(insertaAux(_ra, clave, valor));
+	}
+
+	/**
+	 Operacin modificadora que elimina una clave del rbol.
+	 Si la clave no exista la operacin no tiene efecto.
+	 Las copias previas del rbol no ven el cambio.
+	 @param clave Clave a eliminar.
+	 */
+	void borra(const Clave &clave) {
+		cambiaRaiz(borraAux(_ra, clave));
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada. Es un error preguntar por una clave
+	 que no existe.
+	 @param clave Clave por la que se pregunta.
+	 */
+	const Valor &consulta(const Clave &clave) const {
+		Nodo *p = buscaAux(_ra, clave);
+		if (p == NULL)
+			throw EClaveErronea();
+
+		return p->_valor;
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el rbol de bsqueda.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) const {
+		return buscaAux(_ra, clave) != NULL;
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _ra == NULL;
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Clase interna que implementa un iterador que
+	 recorre las claves del rbol en orden. El iterador
+	 recorre la versin del rbol que exista al crearlo
+	 mientras sta siga viva; para iterar una versin
+	 mientras se modifica el rbol basta con iterar
+	 sobre una copia.
+	 */
+	class Iterador {
+	public:
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+
+			if (_act->_dr)
+				_act = primeroInOrden(_act->_dr);
+			else {
+				if (_ascendientes.esVacia())
+					_act = NULL;
+				else {
+					_act = _ascendientes.cima();
+					_ascendientes.desapila();
+				}
+			}
+		}
+
+		const Clave &clave() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_clave;
+		}
+
+		const Valor &valor() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_valor;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusPersistente;
+
+		Iterador() : _act(NULL) {}
+		Iterador(Nodo *act) {
+			_act = primeroInOrden(act);
+		}
+
+		Nodo *primeroInOrden(Nodo *p) {
+			if (p == NULL)
+				return NULL;
+
+			while (p->_iz != NULL) {
+				_ascendientes.apila(p);
+				p = p->_iz;
+			}
+			return p;
+		}
+
+		// Puntero al nodo actual del recorrido
+		// NULL si hemos llegado al final.
+		Nodo *_act;
+
+		// Ascendientes del nodo actual
+		// an por visitar
+		Pila<Nodo*> _ascendientes;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(_ra);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador(NULL);
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia; O(1), comparte la estructura. */
+	ArbusPersistente(const ArbusPersistente<Clave, Valor> &other) : _ra(NULL) {
+		copia(other);
+	}
+
+	/** Operador de asignacin; O(1), comparte la estructura. */
+	ArbusPersistente<Clave, Valor> &operator=(const ArbusPersistente<Clave, Valor> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	void libera() {
+		libera(_ra);
+	}
+
+	void copia(const ArbusPersistente &other) {
+		assert(this != &other);
+		_ra = other._ra;
+		if (_ra != NULL)
+			_ra->addRef();
+	}
+
+	/**
+	 Sustituye la raz por la de la nueva versin. Se aade
+	 primero la referencia a la nueva raz y luego se suelta
+	 la vieja, de forma que los nodos compartidos por ambas
+	 versiones no llegan a liberarse.
+	 */
+	void cambiaRaiz(Nodo *nueva) {
+		if (nueva != NULL)
+			nueva->addRef();
+		libera(_ra);
+		_ra = nueva;
+	}
+
+private:
+
+	/**
+	 Suelta una referencia a la estructura que comienza en
+	 ra, liberando los nodos que se queden sin referencias.
+	 Se admite que el nodo sea NULL.
+	 */
+	static void libera(Nodo *ra) {
+		if (ra != NULL) {
+			ra->remRef();
+			if (ra->_numRefs == 0)
+				descarta(ra);
+		}
+	}
+
+	/**
+	 Libera un nodo recin creado que al final no se ha
+	 usado (no tiene referencias), soltando las referencias
+	 que l tena a sus hijos. Si el nodo s est referenciado
+	 no se hace nada.
+	 */
+	static void descarta(Nodo *p) {
+		if ((p != NULL) && (p->_numRefs == 0)) {
+			libera(p->_iz);
+			libera(p->_dr);
+			delete p;
+		}
+	}
+
+	static int altura(Nodo *p) {
+		return p == NULL ? 0 : p->_altura;
+	}
+
+	/**
+	 Crea un nodo nuevo con la pareja (clave, valor) y los
+	 hijos dados, reequilibrndolo si la diferencia de alturas
+	 de los hijos es mayor que 2. Slo se crean los nodos
+	 definitivos; los hijos recin creados que desaparecen
+	 con la rotacin se descartan.
+	 */
+	static Nodo *equilibra(Nodo *iz, const Clave &clave, const Valor &valor, Nodo *dr) {
+		int hiz = altura(iz), hdr = altura(dr);
+		Nodo *ret;
+		if (hiz > hdr + 2) {
+			if (altura(iz->_iz) >= altura(iz->_dr))
+				ret = new Nodo(iz->_iz, iz->_clave, iz->_valor,
+							   new Nodo(iz->_dr, clave, valor, dr));
+			else {
+				Nodo *c = iz->_dr;
+				ret = new Nodo(new Nodo(iz->_iz, iz->_clave, iz->_valor, c->_iz),
+							   c->_clave, c->_valor,
+							   new Nodo(c->_dr, clave, valor, dr));
+			}
+			descarta(iz);
+		} else if (hdr > hiz + 2) {
+			if (altura(dr->_dr) >= altura(dr->_iz))
+				ret = new Nodo(new Nodo(iz, clave, valor, dr->_iz),
+							   dr->_clave, dr->_valor, dr->_dr);
+			else {
+				Nodo *c = dr->_iz;
+				ret = new Nodo(new Nodo(iz, clave, valor, c->_iz),
+							   c->_clave, c->_valor,
+							   new Nodo(c->_dr, dr->_clave, dr->_valor, dr->_dr));
+			}
+			descarta(dr);
+		} else
+			ret = new Nodo(iz, clave, valor, dr);
+		return ret;
+	}
+
+	static Nodo *buscaAux(Nodo *p, const Clave &clave) {
+		while (p != NULL) {
+			if (p->_clave == clave)
+				return p;
+			else if (clave < p->_clave)
+				p = p->_iz;
+			else
+				p = p->_dr;
+		}
+		return NULL;
+	}
+
+	/**
+	 Devuelve la raz de una nueva versin de la estructura
+	 p con la pareja (clave, valor) aadida. Los nodos del
+	 camino hasta la clave son nuevos; el resto se comparten.
+	 */
+	static Nodo *insertaAux(Nodo *p, const Clave &clave, const Valor &valor) {
+		if (p == NULL)
+			return new Nodo(NULL, clave, valor, NULL);
+		else if (p->_clave == clave)
+			return new Nodo(p->_iz, clave, valor, p->_dr);
+		else if (clave < p->_clave)
+			return equilibra(insertaAux(p->_iz, clave, valor),
+							 p->_clave, p->_valor, p->_dr);
+		else
+			return equilibra(p->_iz, p->_clave, p->_valor,
+							 insertaAux(p->_dr, clave, valor));
+	}
+
+	/**
+	 Devuelve la raz de una nueva versin de la estructura
+	 p sin la clave dada. Si la clave no est se devuelve
+	 el propio p, sin crear ningn nodo.
+	 */
+	static Nodo *borraAux(Nodo *p, const Clave &clave) {
+		if (p == NULL)
+			return NULL;
+
+		if (p->_clave == clave)
+			return borraRaiz(p);
+		else if (clave < p->_clave) {
+			Nodo *iz = borraAux(p->_iz, clave);
+			if (iz == p->_iz)
+				return p;
+			return equilibra(iz, p->_clave, p->_valor, p->_dr);
+		} else {
+			Nodo *dr = borraAux(p->_dr, clave);
+			if (dr == p->_dr)
+				return p;
+			return equilibra(p->_iz, p->_clave, p->_valor, dr);
+		}
+	}
+
+	/**
+	 Devuelve la raz de una nueva versin de la estructura
+	 p sin su raz: el mnimo del hijo derecho pasa a ocupar
+	 su lugar.
+	 */
+	static Nodo *borraRaiz(Nodo *p) {
+		if (p->_iz == NULL)
+			return p->_dr;
+		if (p->_dr == NULL)
+			return p->_iz;
+
+		Nodo *min = p->_dr;
+		while (min->_iz != NULL)
+			min = min->_iz;
+
+		return equilibra(p->_iz, min->_clave, min->_valor, quitaMin(p->_dr));
+	}
+
+	/**
+	 Devuelve la raz de una nueva versin de la estructura
+	 p (no vaca) sin su clave mnima.
+	 */
+	static Nodo *quitaMin(Nodo *p) {
+		if (p->_iz == NULL)
+			return p->_dr;
+		return equilibra(quitaMin(p->_iz), p->_clave, p->_valor, p->_dr);
+	}
+
+	/**
+	 Puntero a la raz de la estructura jerrquica
+	 de nodos (compartida con otras copias).
+	 */
+	Nodo *_ra;
+};
+
+#endif // __ARBUSPERSISTENTE_H
@@ -0,0 +1,594 @@
+/**
+  @file ArbusPrefijos.h
+
+  Diccionario ordenado con claves de tipo string
+  guardadas con compresin de prefijos (front coding).
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSPREFIJOS_H
+#define __ARBUSPREFIJOS_H
+
+#include "Excepciones.h"
+
+#include <string>
+#include <cstring>
+
+/**
+ Diccionario ordenado con la interfaz de Arbus para
+ claves de tipo std::string, pensado para muchas claves
+ con prefijos comunes largos (rutas de ficheros, URLs,
+ identificadores jerrquicos...).
+
+ En lugar de guardar cada clave en su propio std::string
+ (con su reserva de memoria), las claves se guardan
+ ordenadas en bloques de hasta TAM_BLOQUE parejas, y dentro
+ de cada bloque cada clave se codifica respecto a la
+ anterior (front coding): se guarda la longitud del prefijo
+ que comparte con ella y slo el resto de bytes. La primera
+ clave de cada bloque se guarda entera. Todas las claves de
+ un bloque van seguidas en una nica cadena de bytes, as
+ que recorrer el diccionario en orden es leer memoria
+ consecutiva.
+
+ Para buscar se elige el bloque por bsqueda binaria sobre
+ las primeras claves y se recorre el bloque manteniendo la
+ longitud del prefijo que la clave buscada comparte con la
+ clave anterior. Comparando esa longitud con la del prefijo
+ codificado de la clave siguiente se sabe, casi siempre sin
+ mirar sus bytes, si es menor o mayor que la buscada; slo
+ cuando coinciden se comparan los bytes del resto. Nunca se
+ reconstruye ni se compara una clave completa.
+
+ Insertar y borrar recodifican el bloque afectado, O(log
+ (n / TAM_BLOQUE) + TAM_BLOQUE) comparaciones y copias de
+ claves; un bloque lleno se parte en dos y uno vaco se
+ elimina. Las claves se ordenan como std::string.
+ Valor debe tener constructor sin parmetros.
+ */
+template <class Valor>
+class ArbusPrefijos {
+public:
+	typedef std::string Clave;
+
+	/** Nmero mximo de parejas de un bloque. */
+	enum { TAM_BLOQUE = 32 };
+
+private:
+	/**
+	 Bloque de parejas consecutivas. _datos guarda, para
+	 cada clave, la longitud del prefijo comn con la
+	 anterior, la longitud del resto y los bytes del resto
+	 (las longitudes como nmeros de longitud variable, un
+	 byte si son menores que 128).
+	 */
+	class Bloque {
+	public:
+		Bloque() : _num(0) {}
+
+		std::string _datos;
+		Valor _valores[TAM_BLOQUE];
+		unsigned int _num;
+	};
+
+public:
+
+	/** Constructor; operacion ArbolVacio */
+	ArbusPrefijos() {
+		inicia();
+	}
+
+	/** Destructor; elimina los bloques. */
+	~ArbusPrefijos() {
+		libera();
+	}
+
+	/**
+	 Operacin generadora que aade una nueva clave/valor
+	 al diccionario.
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave. Si la clave
+	 ya se haba insertado previamente, sustituimos el valor
+	 viejo por el nuevo.
+	 */
+	void inserta(const Clave &clave, const Valor &valor) {
+		if (_numBloques == 0) {
+			Bloque *b = new Bloque();
+			Clave claves[1] = { clave };
+			codifica(b, claves, 1);
+			b->_valores[0] = valor;
+			insertaBloque(0, b);
+			_numElems++;
+			return;
+		}
+
+		unsigned int b = bloquePara(clave);
+		bool encontrada;
+		unsigned int i = buscaEnBloque(_bloques[b], clave, encontrada);
+		if (encontrada) {
+			_bloques[b]->_valores[i] = valor;
+			return;
+		}
+
+		// Se decodifica el bloque entero, se inserta la
+		// pareja en su sitio y se vuelve a codificar,
+		// partindolo en dos si no cabe
+		Clave claves[TAM_BLOQUE + 1];
+		Valor valores[TAM_BLOQUE + 1];
+		Bloque *bloque = _bloques[b];
+		unsigned int n = decodifica(bloque, claves, valores);
+		for (unsigned int j = n; j > i; --j) {
+			claves[j].swap(claves[j - 1]);
+			valores[j] = valores[j - 1];
+		}
+		claves[i] = clave;
+		valores[i] = valor;
+		++n;
+
+		if (n <= TAM_BLOQUE)
+			rellena(bloque, claves, valores, n);
+		else {
+			unsigned int mitad = n / 2;
+			Bloque *nuevo = new Bloque();
+			rellena(bloque, claves, valores, mitad);
+			rellena(nuevo, claves + mitad, valores + mitad, n - mitad);
+			insertaBloque(b + 1, nuevo);
+		}
+		_numElems++;
+	}
+
+	/**
+	 Operacin modificadora que elimina una clave del
+	 diccionario. Si la clave no exista la operacin no
+	 tiene efecto.
+	 @param clave Clave a eliminar.
+	 */
+	void borra(const Clave &clave) {
+		if (_numBloques == 0)
+			return;
+
+		unsigned int b = bloquePara(clave);
+		bool encontrada;
+		unsigned int i = buscaEnBloque(_bloques[b], clave, encontrada);
+		if (!encontrada)
+			return;
+
+		Clave claves[TAM_BLOQUE];
+		Valor valores[TAM_BLOQUE];
+		Bloque *bloque = _bloques[b];
+		unsigned int n = decodifica(bloque, claves, valores);
+		for (unsigned int j = i; j + 1 < n; ++j) {
+			claves[j].swap(claves[j + 1]);
+			valores[j] = valores[j + 1];
+		}
+		--n;
+
+		if (n == 0)
+			quitaBloque(b);
+		else {
+			// El ltimo valor ha quedado repetido; se
+			// sustituye para no retener sus recursos
+			bloque->_valores[n] = Valor();
+			rellena(bloque, claves, valores, n);
+		}
+		_numElems--;
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada. Es un error preguntar por una clave
+	 que no existe.
+	 @param clave Clave por la que se pregunta.
+	 */
+	const Valor &consulta(const Clave &clave) const {
+		if (_numBloques > 0) {
+			unsigned int b = bloquePara(clave);
+			bool encontrada;
+			unsigned int i = buscaEnBloque(_bloques[b], clave, encontrada);
+			if (encontrada)
+				return _bloques[b]->_valores[i];
+		}
+		throw EClaveErronea();
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el diccionario.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) const {
+		if (_numBloques == 0)
+			return false;
+		bool encontrada;
+		buscaEnBloque(_bloques[bloquePara(clave)], clave, encontrada);
+		return encontrada;
+	}
+
+	/**
+	 Operacin observadora que devuelve si el diccionario
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _numElems == 0;
+	}
+
+	/** Nmero de claves del diccionario. */
+	unsigned int numElems() const {
+		return _numElems;
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Clase interna que implementa un iterador que
+	 recorre las claves en orden. Guarda la clave actual
+	 reconstruida; avanzar consiste en recortarla a la
+	 longitud del prefijo comn con la siguiente y aadirle
+	 el resto, ledo a continuacin en el bloque.
+	 */
+	class Iterador {
+	public:
+		void avanza() {
+			if (esFinal()) throw EAccesoInvalido();
+
+			++_pos;
+			if (_pos == _dic->_bloques[_bloque]->_num) {
+				++_bloque;
+				_pos = 0;
+				_desplazamiento = 0;
+				_clave.clear();
+				if (esFinal())
+					return;
+			}
+			leeClave(_dic->_bloques[_bloque]->_datos, _desplazamiento, _clave);
+		}
+
+		const Clave &clave() const {
+			if (esFinal()) throw EAccesoInvalido();
+			return _clave;
+		}
+
+		const Valor &valor() const {
+			if (esFinal()) throw EAccesoInvalido();
+			return _dic->_bloques[_bloque]->_valores[_pos];
+		}
+
+		bool operator==(const Iterador &other) const {
+			return (_bloque == other._bloque) && (_pos == other._pos);
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusPrefijos;
+
+		/**
+		 Iterador a la pareja pos del bloque dado (o al final
+		 si el bloque no existe).
+		 */
+		Iterador(const ArbusPrefijos *dic, unsigned int bloque, unsigned int pos) :
+			_dic(dic), _bloque(bloque), _pos(0), _desplazamiento(0) {
+			if (esFinal())
+				return;
+			if (pos == _dic->_bloques[_bloque]->_num) {
+				// Justo tras la ltima del bloque: primera del siguiente
+				++_bloque;
+				if (esFinal())
+					return;
+				pos = 0;
+			}
+			const std::string &datos = _dic->_bloques[_bloque]->_datos;
+			leeClave(datos, _desplazamiento, _clave);
+			for (_pos = 0; _pos < pos; ++_pos)
+				leeClave(datos, _desplazamiento, _clave);
+		}
+
+		bool esFinal() const {
+			return _bloque >= _dic->_numBloques;
+		}
+
+		// Diccionario recorrido
+		const ArbusPrefijos *_dic;
+
+		// Bloque y posicin dentro de l de la pareja actual
+		unsigned int _bloque;
+		unsigned int _pos;
+
+		// Posicin en _datos de la codificacin de la
+		// clave siguiente a la actual
+		size_t _desplazamiento;
+
+		// Clave actual, reconstruida
+		Clave _clave;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(this, 0, 0);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador(this, _numBloques, 0);
+	}
+
+	/**
+	 Devuelve un iterador a la primera clave que es
+	 mayor o igual que la dada (cota inferior). Junto con
+	 el recorrido en orden permite consultas por prefijo.
+	 @param clave Clave desde la que empezar el recorrido.
+	 @return Iterador a la primera clave >= clave; final()
+	 si no hay ninguna.
+	 */
+	Iterador buscaDesde(const Clave &clave) const {
+		if (_numBloques == 0)
+			return final();
+		unsigned int b = bloquePara(clave);
+		bool encontrada;
+		unsigned int i = buscaEnBloque(_bloques[b], clave, encontrada);
+		return Iterador(this, b, i);
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbusPrefijos(const ArbusPrefijos<Valor> &other) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbusPrefijos<Valor> &operator=(const ArbusPrefijos<Valor> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	void inicia() {
+		_tamBloques = TAM_INICIAL;
+		_bloques = new Bloque*[_tamBloques];
+		_numBloques = 0;
+		_numElems = 0;
+	}
+
+	void libera() {
+		for (unsigned int i = 0; i < _numBloques; ++i)
+			delete _bloques[i];
+		delete []_bloques;
+		_bloques = NULL;
+	}
+
+	void copia(const ArbusPrefijos &other) {
+		_tamBloques = other._numBloques + TAM_INICIAL;
+		_bloques = new Bloque*[_tamBloques];
+		_numBloques = other._numBloques;
+		_numElems = other._numElems;
+		for (unsigned int i = 0; i < _numBloques; ++i)
+			_bloques[i] = new Bloque(*other._bloques[i]);
+	}
+
+private:
+
+	/** Tamao inicial del vector de bloques. */
+	enum { TAM_INICIAL = 16 };
+
+	// //
+	// CODIFICACIN DE LOS BLOQUES
+	// //
+
+	/** Aade un nmero de longitud variable a s. */
+	static void escribeNum(std::string &s, unsigned int n) {
+		while (n >= 128) {
+			s += (char)((n & 127) | 128);
+			n >>= 7;
+		}
+		s += (char)n;
+	}
+
+	/** Lee un nmero de longitud variable de s en pos. */
+	static unsigned int leeNum(const std::string &s, size_t &pos) {
+		unsigned int ret = 0;
+		unsigned int desp = 0;
+		unsigned char c;
+		do {
+			c = (unsigned char)s[pos++];
+			ret |= (unsigned int)(c & 127) << desp;
+			desp += 7;
+		} while (c & 128);
+		return ret;
+	}
+
+	/**
+	 Lee la codificacin de la clave que empieza en pos
+	 y la reconstruye en clave, que debe contener la clave
+	 anterior del bloque.
+	 */
+	static void leeClave(const std::string &datos, size_t &pos, Clave &clave) {
+		unsigned int comun = leeNum(datos, pos);
+		unsigned int resto = leeNum(datos, pos);
+		clave.resize(comun);
+		clave.append(datos, pos, resto);
+		pos += resto;
+	}
+
+	/** Codifica en el bloque las n claves (ordenadas) dadas. */
+	static void codifica(Bloque *b, const Clave *claves, unsigned int n) {
+		b->_datos.clear();
+		for (unsigned int i = 0; i < n; ++i) {
+			unsigned int comun = 0;
+			if (i > 0) {
+				const Clave &ant = claves[i - 1];
+				while ((comun < ant.size()) && (comun < claves[i].size()) &&
+					   (ant[comun] == claves[i][comun]))
+					++comun;
+			}
+			escribeNum(b->_datos, comun);
+			escribeNum(b->_datos, claves[i].size() - comun);
+			b->_datos.append(claves[i], comun, std::string::npos);
+		}
+		b->_num = n;
+	}
+
+	/** Codifica en el bloque las n parejas dadas. */
+	static void rellena(Bloque *b, const Clave *claves, const Valor *valores, unsigned int n) {
+		codifica(b, claves, n);
+		for (unsigned int i = 0; i < n; ++i)
+			b->_valores[i] = valores[i];
+	}
+
+	/**
+	 Decodifica todas las parejas del bloque.
+	 @return Nmero de parejas.
+	 */
+	static unsigned int decodifica(const Bloque *b, Clave *claves, Valor *valores) {
+		size_t pos = 0;
+		Clave actual;
+		for (unsigned int i = 0; i < b->_num; ++i) {
+			leeClave(b->_datos, pos, actual);
+			claves[i] = actual;
+			valores[i] = b->_valores[i];
+		}
+		return b->_num;
+	}
+
+	// //
+	// BSQUEDA
+	// //
+
+	/**
+	 Compara la clave con la primera del bloque (guardada
+	 entera al principio de _datos): negativo, 0 o positivo
+	 si es menor, igual o mayor.
+	 */
+	static int comparaConPrimera(const Clave &clave, const Bloque *b) {
+		size_t pos = 0;
+		leeNum(b->_datos, pos);
+		unsigned int tam = leeNum(b->_datos, pos);
+		return clave.compare(0, clave.size(), b->_datos.data() + pos, tam);
+	}
+
+	/**
+	 ndice del ltimo bloque cuya primera clave es menor
+	 o igual que la dada (0 si no hay ninguno): el nico en
+	 el que puede estar o debe insertarse. Hay al menos un
+	 bloque.
+	 */
+	unsigned int bloquePara(const Clave &clave) const {
+		unsigned int ini = 1, fin = _numBloques;
+		// Buscamos en [ini, fin) el primer bloque cuya
+		// primera clave es mayor que la dada
+		while (ini < fin) {
+			unsigned int m = (ini + fin) / 2;
+			if (comparaConPrimera(clave, _bloques[m]) < 0)
+				fin = m;
+			else
+				ini = m + 1;
+		}
+		return ini - 1;
+	}
+
+	/**
+	 Posicin en el bloque de la primera clave mayor o
+	 igual que la dada (b->_num si no hay ninguna).
+
+	 Se recorre el bloque sabiendo que todas las claves
+	 anteriores son menores que la buscada, y guardando en
+	 iguales la longitud del prefijo que la buscada comparte
+	 con la anterior. Si la siguiente comparte con la anterior
+	 un prefijo ms largo, tambin es menor; si lo comparte
+	 ms corto, en la primera posicin distinta es mayor que la
+	 anterior, que ah coincide con la buscada, luego es mayor.
+	 Slo si la longitud coincide hay que mirar los bytes del
+	 resto, a partir de la posicin iguales.
+	 @param encontrada Si la clave de esa posicin es la buscada.
+	 */
+	static unsigned int buscaEnBloque(const Bloque *b, const Clave &clave, bool &encontrada) {
+		const std::string &datos = b->_datos;
+		size_t pos = 0;
+		size_t iguales = 0;
+		encontrada = false;
+
+		for (unsigned int i = 0; i < b->_num; ++i) {
+			unsigned int comun = leeNum(datos, pos);
+			unsigned int resto = leeNum(datos, pos);
+			const char *sufijo = datos.data() + pos;
+			pos += resto;
+
+			if (comun > iguales)
+				continue;
+			if (comun < iguales)
+				return i;
+
+			size_t k = 0;
+			while ((k < resto) && (iguales + k < clave.size()) &&
+				   (sufijo[k] == clave[iguales + k]))
+				++k;
+
+			if (iguales + k == clave.size()) {
+				// La buscada es prefijo de la actual (o igual)
+				encontrada = (k == resto);
+				return i;
+			}
+			if ((k < resto) &&
+				((unsigned char)sufijo[k] > (unsigned char)clave[iguales + k]))
+				return i;
+			iguales += k;
+		}
+		return b->_num;
+	}
+
+	// //
+	// GESTIN DEL VECTOR DE BLOQUES
+	// //
+
+	/** Inserta un bloque en la posicin i del vector. */
+	void insertaBloque(unsigned int i, Bloque *b) {
+		if (_numBloques == _tamBloques) {
+			Bloque **viejo = _bloques;
+			_tamBloques *= 2;
+			_bloques = new Bloque*[_tamBloques];
+			std::memcpy(_bloques, viejo, _numBloques * sizeof(Bloque*));
+			delete []viejo;
+		}
+		std::memmove(_bloques + i + 1, _bloques + i, (_numBloques - i) * sizeof(Bloque*));
+		_bloques[i] = b;
+		_numBloques++;
+	}
+
+	/** Elimina el bloque de la posicin i del vector. */
+	void quitaBloque(unsigned int i) {
+		delete _bloques[i];
+		std::memmove(_bloques + i, _bloques + i + 1, (_numBloques - i - 1) * sizeof(Bloque*));
+		_numBloques--;
+	}
+
+	/** Bloques, ordenados por sus claves. */
+	Bloque **_bloques;
+
+	/** Tamao del vector _bloques. */
+	unsigned int _tamBloques;
+
+	/** Nmero de bloques. */
+	unsigned int _numBloques;
+
+	/** Nmero de parejas. */
+	unsigned int _numElems;
+};
+
+#endif // __ARBUSPREFIJOS_H
@@ -0,0 +1,415 @@
+/**
+  @file ArbusSplay.h
+
+  Implementacin del TAD Arbol de Bsqueda mediante
+  rboles autoajustables (splay trees) descendentes.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSSPLAY_H
+#define __ARBUSSPLAY_H
+
+#include "Excepciones.h"
+
+#include "Pila.h" // Usado en los iteradores y en la copia
+
+/**
+ Implementacin del TAD Arbus mediante un rbol splay
+ (Sleator y Tarjan). Cada operacin que busca una clave
+ (inserta, borra, consulta y esta) la "reflota": mediante
+ rotaciones, la clave buscada (o la ltima visitada si no
+ est) pasa a ser la raz, y los nodos del camino recorrido
+ quedan aproximadamente a la mitad de profundidad.
+
+ El rbol no guarda ninguna informacin de equilibrio,
+ pero el coste amortizado de cada operacin es O(log n) y,
+ adems, se adapta a la distribucin de los accesos: las
+ claves consultadas a menudo o hace poco quedan cerca de
+ la raz. Con accesos muy sesgados (unas pocas claves
+ acaparan la mayora de las consultas) el coste amortizado
+ se acerca a la entropa de la distribucin, sin necesidad
+ de una cach aparte.
+
+ El reflotado se hace de arriba a abajo (top-down splay),
+ en una nica pasada y sin recursin ni punteros al padre.
+
+ Como esta y consulta modifican la estructura, no son
+ operaciones const e invalidan los iteradores existentes.
+ */
+template <class Clave, class Valor>
+class ArbusSplay {
+private:
+	/**
+	 Clase nodo que almacena internamente la pareja (clave, valor)
+	 y los punteros al hijo izquierdo y al hijo derecho.
+	 */
+	class Nodo {
+	public:
+		Nodo(const Clave &clave, const Valor &valor)
+			: _clave(clave), _valor(valor), _iz(NULL), _dr(NULL) {}
+
+		Clave _clave;
+		Valor _valor;
+		Nodo *_iz;
+		Nodo *_dr;
+	};
+
+public:
+
+	/** Constructor; operacion ArbolVacio */
+	ArbusSplay() : _ra(NULL) {
+	}
+
+	/** Destructor; elimina la estructura jerrquica de nodos. */
+	~ArbusSplay() {
+		libera();
+		_ra = NULL;
+	}
+
+	/**
+	 Operacin generadora que aade una nueva clave/valor
+	 al rbol, que queda en la raz.
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave. Si la clave
+	 ya se haba insertado previamente, sustituimos el valor
+	 viejo por el nuevo.
+	 */
+	void inserta(const Clave &clave, const Valor &valor) {
+		if (_ra == NULL) {
+			_ra = new Nodo(clave, valor);
+			return;
+		}
+
+		_ra = reflota(_ra, clave);
+		if (_ra->_clave == clave) {
+			_ra->_valor = valor;
+			return;
+		}
+
+		// La raz es ahora la clave inmediatamente anterior
+		// o posterior a la nueva; la nueva pasa a estar
+		// encima de ella.
+		Nodo *nuevo = new Nodo(clave, valor);
+		if (clave < _ra->_clave) {
+			nuevo->_iz = _ra->_iz;
+			nuevo->_dr = _ra;
+			_ra->_iz = NULL;
+		} else {
+			nuevo->_dr = _ra->_dr;
+			nuevo->_iz = _ra;
+			_ra->_dr = NULL;
+		}
+		_ra = nuevo;
+	}
+
+	/**
+	 Operacin modificadora que elimina una clave del rbol.
+	 Si la clave no exista la operacin no tiene efecto.
+	 @param clave Clave a eliminar.
+	 */
+	void borra(const Clave &clave) {
+		if (_ra == NULL)
+			return;
+
+		_ra = reflota(_ra, clave);
+		if (!(_ra->_clave == clave))
+			return;
+
+		// Reflotando la misma clave en el hijo izquierdo
+		// (donde todas son menores) sube su mximo, que no
+		// tiene hijo derecho; ah colgamos el hijo derecho.
+		Nodo *viejo = _ra;
+		if (viejo->_iz == NULL)
+			_ra = viejo->_dr;
+		else {
+			_ra = reflota(viejo->_iz, clave);
+			_ra->_dr = viejo->_dr;
+		}
+		delete viejo;
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada, que queda en la raz. Es un error
+	 preguntar por una clave que no existe.
+	 @param clave Clave por la que se pregunta.
+	 */
+	const Valor &consulta(const Clave &clave) {
+		if (_ra != NULL)
+			_ra = reflota(_ra, clave);
+		if ((_ra == NULL) || !(_ra->_clave == clave))
+			throw EClaveErronea();
+
+		return _ra->_valor;
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el rbol de bsqueda. Si est,
+	 queda en la raz.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) {
+		if (_ra == NULL)
+			return false;
+		_ra = reflota(_ra, clave);
+		return _ra->_clave == clave;
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _ra == NULL;
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Clase interna que implementa un iterador que
+	 recorre las claves del rbol en orden. No reflota
+	 ninguna clave.
+	 */
+	class Iterador {
+	public:
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+
+			if (_act->_dr)
+				_act = primeroInOrden(_act->_dr);
+			else {
+				if (_ascendientes.esVacia())
+					_act = NULL;
+				else {
+					_act = _ascendientes.cima();
+					_ascendientes.desapila();
+				}
+			}
+		}
+
+		const Clave &clave() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_clave;
+		}
+
+		const Valor &valor() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_valor;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusSplay;
+
+		Iterador() : _act(NULL) {}
+		Iterador(Nodo *act) {
+			_act = primeroInOrden(act);
+		}
+
+		Nodo *primeroInOrden(Nodo *p) {
+			if (p == NULL)
+				return NULL;
+
+			while (p->_iz != NULL) {
+				_ascendientes.apila(p);
+				p = p->_iz;
+			}
+			return p;
+		}
+
+		// Puntero al nodo actual del recorrido
+		// NULL si hemos llegado al final.
+		Nodo *_act;
+
+		// Ascendientes del nodo actual
+		// an por visitar
+		Pila<Nodo*> _ascendientes;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(_ra);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador(NULL);
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbusSplay(const ArbusSplay<Clave, Valor> &other) : _ra(NULL) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbusSplay<Clave, Valor> &operator=(const ArbusSplay<Clave, Valor> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	void libera() {
+		libera(_ra);
+	}
+
+	void copia(const ArbusSplay &other) {
+		_ra = copiaAux(other._ra);
+	}
+
+private:
+
+	/**
+	 Elimina todos los nodos de la estructura que comienza
+	 en ra. Un rbol splay puede llegar a tener profundidad
+	 n, as que no se usa recursin: mientras la raz tenga
+	 hijo izquierdo se rota a la derecha, y cuando no lo
+	 tiene se borra y se contina por el hijo derecho.
+	 */
+	static void libera(Nodo *ra) {
+		while (ra != NULL) {
+			if (ra->_iz != NULL) {
+				Nodo *iz = ra->_iz;
+				ra->_iz = iz->_dr;
+				iz->_dr = ra;
+				ra = iz;
+			} else {
+				Nodo *dr = ra->_dr;
+				delete ra;
+				ra = dr;
+			}
+		}
+	}
+
+	/**
+	 Copia la estructura jerrquica de nodos que comienza
+	 en ra. Como en libera, se evita la recursin: se
+	 guardan en una pila los nodos originales cuyos hijos
+	 quedan por copiar, junto a sus copias.
+	 */
+	static Nodo *copiaAux(Nodo *ra) {
+		if (ra == NULL)
+			return NULL;
+
+		Pila<Nodo*> originales, copias;
+		Nodo *ret = new Nodo(ra->_clave, ra->_valor);
+		originales.apila(ra);
+		copias.apila(ret);
+
+		while (!originales.esVacia()) {
+			Nodo *orig = originales.cima();
+			Nodo *copia = copias.cima();
+			originales.desapila();
+			copias.desapila();
+
+			if (orig->_iz != NULL) {
+				copia->_iz = new Nodo(orig->_iz->_clave, orig->_iz->_valor);
+				originales.apila(orig->_iz);
+				copias.apila(copia->_iz);
+			}
+			if (orig->_dr != NULL) {
+				copia->_dr = new Nodo(orig->_dr->_clave, orig->_dr->_valor);
+				originales.apila(orig->_dr);
+				copias.apila(copia->_dr);
+			}
+		}
+		return ret;
+	}
+
+	/**
+	 Reflota (splay) la clave en la estructura no vaca que
+	 comienza en t: devuelve la nueva raz, que es el nodo con
+	 la clave si est o, si no, el ltimo nodo visitado al
+	 buscarla (su antecesor o su sucesor en inorden).
+
+	 Se desciende desde la raz partiendo el rbol en tres:
+	 el rbol izquierdo (claves menores que la buscada), el
+	 central (el que queda por recorrer) y el derecho (claves
+	 mayores). Cada nodo que se deja atrs se engancha al rbol
+	 izquierdo o derecho a travs de huecoIz/huecoDr, que
+	 apuntan al puntero donde ir el siguiente nodo. En los
+	 pasos zig-zig se rota antes de enganchar, que es lo que
+	 reduce la profundidad del camino.
+	 */
+	static Nodo *reflota(Nodo *t, const Clave &clave) {
+		Nodo *arbolIz = NULL, *arbolDr = NULL;
+		Nodo **huecoIz = &arbolIz;
+		Nodo **huecoDr = &arbolDr;
+
+		while (!(t->_clave == clave)) {
+			if (clave < t->_clave) {
+				if (t->_iz == NULL)
+					break;
+				if (clave < t->_iz->_clave) {
+					// zig-zig: rotacin a la derecha
+					Nodo *iz = t->_iz;
+					t->_iz = iz->_dr;
+					iz->_dr = t;
+					t = iz;
+					if (t->_iz == NULL)
+						break;
+				}
+				// t y su hijo derecho pasan al rbol derecho
+				*huecoDr = t;
+				huecoDr = &t->_iz;
+				t = t->_iz;
+			} else {
+				if (t->_dr == NULL)
+					break;
+				if (t->_dr->_clave < clave) {
+					// zag-zag: rotacin a la izquierda
+					Nodo *dr = t->_dr;
+					t->_dr = dr->_iz;
+					dr->_iz = t;
+					t = dr;
+					if (t->_dr == NULL)
+						break;
+				}
+				// t y su hijo izquierdo pasan al rbol izquierdo
+				*huecoIz = t;
+				huecoIz = &t->_dr;
+				t = t->_dr;
+			}
+		}
+
+		// Reensamblado: los hijos de t completan los rboles
+		// izquierdo y derecho, que pasan a ser sus hijos.
+		*huecoIz = t->_iz;
+		*huecoDr = t->_dr;
+		t->_iz = arbolIz;
+		t->_dr = arbolDr;
+		return t;
+	}
+
+	/**
+	 Puntero a la raz de la estructura jerrquica
+	 de nodos.
+	 */
+	Nodo *_ra;
+};
+
+#endif // __ARBUSSPLAY_H
@@ -0,0 +1,564 @@
+/**
+  @file ArbusTreap.h
+
+  Implementacin del TAD Arbol de Bsqueda mediante un
+  treap (rbol de bsqueda con prioridades aleatorias),
+  con operaciones de divisin y fusin.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARBUSTREAP_H
+#define __ARBUSTREAP_H
+
+#include "Excepciones.h"
+
+#include "Pila.h" // Usado internamente por los iteradores
+
+#include <exception> // Excepciones de los hilos de aplica
+#include <thread> // Paralelismo fork-join en aplica
+
+/**
+ Implementacin del TAD Arbus mediante un treap: cada
+ nodo recibe al crearse una prioridad aleatoria, y el
+ rbol es a la vez un rbol de bsqueda por clave y un
+ montculo (de mximos) por prioridad. La forma del rbol
+ es la misma que si las claves se hubieran insertado en
+ un orden aleatorio, as que la altura esperada es
+ O(log n) sea cual sea el orden real de insercin.
+
+ Las dos operaciones bsicas son:
+
+ - divide(clave): separa el rbol en las claves menores
+ que la dada y las mayores o iguales. O(log n) esperado.
+
+ - fusiona(otro): la inversa; pega detrs de este rbol
+ otro cuyas claves son todas mayores. O(log n) esperado.
+
+ Con ellas se puede trocear un diccionario grande en
+ fragmentos por rangos de clave, procesarlos por separado
+ (en hilos distintos, por ejemplo) y volver a juntarlos.
+ Para procesar el rbol entero est adems aplica(f), que
+ recorre subrboles disjuntos en paralelo.
+
+ Cada nodo guarda el nmero de nodos de su subrbol, que
+ se usa para decidir cundo merece la pena lanzar un hilo
+ y hace numElems() O(1).
+
+ El resto de operaciones (consulta, esta, esVacio y los
+ iteradores) se comportan igual que en Arbus.
+ */
+template <class Clave, class Valor>
+class ArbusTreap {
+private:
+	/**
+	 Clase nodo que almacena internamente la pareja (clave, valor),
+	 los punteros al hijo izquierdo y al hijo derecho, la
+	 prioridad y el tamao del subrbol que comienza en l.
+	 */
+	class Nodo {
+	public:
+		Nodo(const Clave &clave, const Valor &valor, unsigned int prioridad)
+			: _clave(clave), _valor(valor), _iz(NULL), _dr(NULL),
+			  _prioridad(prioridad), _tam(1) {}
+
+		Clave _clave;
+		Valor _valor;
+		Nodo *_iz;
+		Nodo *_dr;
+		unsigned int _prioridad;
+		unsigned int _tam;
+	};
+
+public:
+
+	/**
+	 Nmero mnimo de nodos de un subrbol para que aplica
+	 lance un hilo para su hijo izquierdo.
+	 */
+	enum { UMBRAL_PARALELO = 1 << 12 };
+
+	/** Constructor; operacion ArbolVacio */
+	ArbusTreap() : _ra(NULL), _semilla(SEMILLA_INICIAL) {
+	}
+
+	/** Destructor; elimina la estructura jerrquica de nodos. */
+	~ArbusTreap() {
+		libera();
+		_ra = NULL;
+	}
+
+	/**
+	 Operacin generadora que aade una nueva clave/valor
+	 a un rbol de bsqueda. O(log n) esperado.
+	 @param clave Clave nueva.
+	 @param valor Valor asociado a esa clave. Si la clave
+	 ya se haba insertado previamente, sustituimos el valor
+	 viejo por el nuevo.
+	 */
+	void inserta(const Clave &clave, const Valor &valor) {
+		Nodo *p = buscaAux(_ra, clave);
+		if (p != NULL)
+			p->_valor = valor;
+		else
+			_ra = insertaAux(_ra, new Nodo(clave, valor, prioridad()));
+	}
+
+	/**
+	 Operacin modificadora que elimina una clave del rbol.
+	 Si la clave no exista la operacin no tiene efecto.
+	 O(log n) esperado.
+	 @param clave Clave a eliminar.
+	 */
+	void borra(const Clave &clave) {
+		_ra = borraAux(_ra, clave);
+	}
+
+	/**
+	 Operacin observadora que devuelve el valor asociado
+	 a una clave dada.
+
+	 consulta(e, inserta(c, v, arbol)) = v si e == c
+	 consulta(e, inserta(c, v, arbol)) = consulta(e, arbol) si e != c
+	 error consulta(ArbolVacio)
+
+	 @param clave Clave por la que se pregunta.
+	 */
+	const Valor &consulta(const Clave &clave) const {
+		Nodo *p = buscaAux(_ra, clave);
+		if (p == NULL)
+			throw EClaveErronea();
+
+		return p->_valor;
+	}
+
+	/**
+	 Operacin observadora que permite averiguar si una clave
+	 determinada est o no en el rbol de bsqueda.
+	 @param clave Clave por la que se pregunta.
+	 */
+	bool esta(const Clave &clave) const {
+		return buscaAux(_ra, clave) != NULL;
+	}
+
+	/**
+	 Operacin observadora que devuelve si el rbol
+	 es vaco (no contiene elementos) o no.
+	 */
+	bool esVacio() const {
+		return _ra == NULL;
+	}
+
+	/** Nmero de claves del rbol. O(1). */
+	unsigned int numElems() const {
+		return tam(_ra);
+	}
+
+	// //
+	// DIVISIN Y FUSIN
+	// //
+
+	/**
+	 Divide el rbol por una clave: este rbol se queda con
+	 las claves menores que la dada y se devuelve otro rbol
+	 con las mayores o iguales. No se copian nodos.
+	 O(log n) esperado.
+	 @param clave Clave por la que dividir.
+	 @return rbol con las claves >= clave.
+	 */
+	ArbusTreap divide(const Clave &clave) {
+		Nodo *iz, *dr;
+		divideAux(_ra, clave, iz, dr);
+		_ra = iz;
+		return ArbusTreap(dr, prioridad());
+	}
+
+	/**
+	 Aade a este rbol todas las parejas de otro, cuyas
+	 claves tienen que ser todas mayores que las de ste
+	 (como las de los dos rboles que deja divide). Es un
+	 error fusionar rboles cuyos rangos de claves se
+	 solapan. No se copian nodos; otro queda vaco.
+	 O(log n) esperado.
+	 @param otro rbol con las claves mayores; queda vaco.
+	 */
+	void fusiona(ArbusTreap &otro) {
+		if ((this == &otro) || (otro._ra == NULL))
+			return;
+		if ((_ra != NULL) && !(ultimo(_ra)->_clave < primero(otro._ra)->_clave))
+			throw EClaveErronea();
+
+		_ra = fusionaAux(_ra, otro._ra);
+		otro._ra = NULL;
+	}
+
+	/**
+	 Aplica f(clave, valor) a todas las parejas del rbol;
+	 f puede modificar el valor (que recibe por referencia)
+	 pero no la clave.
+
+	 Si paralelo es false se llama a f en orden de clave. Si
+	 es true, el hijo izquierdo de los subrboles de al menos
+	 UMBRAL_PARALELO nodos se procesa en otro hilo mientras
+	 el hilo actual sigue con el propio nodo y el hijo
+	 derecho, hasta agotar los hilos disponibles. Cada pareja
+	 se visita exactamente una vez, pero en un orden
+	 cualquiera y desde varios hilos a la vez, as que f
+	 tiene que ser segura entre hilos: se ejecuta
+	 concurrentemente sobre parejas distintas, y si usa
+	 estado compartido (el propio objeto funcin, que
+	 todos los hilos comparten, o variables globales) debe
+	 protegerlo ella misma.
+
+	 Si f lanza una excepcin, se espera a los dems hilos
+	 y se propaga a quien llam a aplica (si lanzan varios,
+	 una cualquiera de ellas); las parejas ya visitadas
+	 quedan modificadas.
+	 @param f Funcin u objeto funcin a aplicar.
+	 @param paralelo Si es true, se usan varios hilos.
+	 */
+	template <class F>
+	void aplica(F f, bool paralelo = false) {
+		aplicaAux(_ra, f, hilos(paralelo));
+	}
+
+	// //
+	// OPERACIONES RELACIONADAS CON LOS ITERADORES
+	// //
+
+	/**
+	 Clase interna que implementa un iterador que
+	 recorre las claves del rbol en orden.
+	 */
+	class Iterador {
+	public:
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+
+			// Si hay hijo derecho, saltamos al primero
+			// en inorden del hijo derecho
+			if (_act->_dr)
+				_act = primeroInOrden(_act->_dr);
+			else {
+				// Si no, vamos al primer ascendiente
+				// no visitado.
+				if (_ascendientes.esVacia())
+					_act = NULL;
+				else {
+					_act = _ascendientes.cima();
+					_ascendientes.desapila();
+				}
+			}
+		}
+
+		const Clave &clave() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_clave;
+		}
+
+		const Valor &valor() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_valor;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	protected:
+		friend class ArbusTreap;
+
+		Iterador() : _act(NULL) {}
+		Iterador(Nodo *act) {
+			_act = primeroInOrden(act);
+		}
+
+		Nodo *primeroInOrden(Nodo *p) {
+			if (p == NULL)
+				return NULL;
+
+			while (p->_iz != NULL) {
+				_ascendientes.apila(p);
+				p = p->_iz;
+			}
+			return p;
+		}
+
+		// Puntero al nodo actual del recorrido
+		// NULL si hemos llegado al final.
+		Nodo *_act;
+
+		// Ascendientes del nodo actual
+		// an por visitar
+		Pila<Nodo*> _ascendientes;
+	};
+
+	/**
+	 Devuelve el iterador al principio del recorrido.
+	 */
+	Iterador principio() const {
+		return Iterador(_ra);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() const {
+		return Iterador(NULL);
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ArbusTreap(const ArbusTreap<Clave, Valor> &other) : _ra(NULL) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ArbusTreap<Clave, Valor> &operator=(const ArbusTreap<Clave, Valor> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	/**
+	 Constructor protegido que crea un rbol a partir de
+	 una estructura jerrquica de nodos previamente creada.
+	 Se utiliza en divide.
+	 */
+	ArbusTreap(Nodo *raiz, unsigned int semilla) : _ra(raiz), _semilla(semilla) {
+		if (_semilla == 0)
+			_semilla = SEMILLA_INICIAL;
+	}
+
+	void libera() {
+		libera(_ra);
+	}
+
+	void copia(const ArbusTreap &other) {
+		_ra = copiaAux(other._ra);
+		_semilla = other._semilla;
+	}
+
+private:
+
+	/** Semilla de las prioridades (no puede ser 0). */
+	enum { SEMILLA_INICIAL = 2463534242u };
+
+	/**
+	 Devuelve la siguiente prioridad pseudoaleatoria
+	 (generador xorshift de 32 bits).
+	 */
+	unsigned int prioridad() {
+		_semilla ^= _semilla << 13;
+		_semilla ^= _semilla >> 17;
+		_semilla ^= _semilla << 5;
+		return _semilla;
+	}
+
+	static unsigned int tam(Nodo *p) {
+		return p == NULL ? 0 : p->_tam;
+	}
+
+	/** Recalcula el tamao de un nodo a partir del de sus hijos. */
+	static void actualiza(Nodo *p) {
+		p->_tam = 1 + tam(p->_iz) + tam(p->_dr);
+	}
+
+	static Nodo *primero(Nodo *p) {
+		while (p->_iz != NULL)
+			p = p->_iz;
+		return p;
+	}
+
+	static Nodo *ultimo(Nodo *p) {
+		while (p->_dr != NULL)
+			p = p->_dr;
+		return p;
+	}
+
+	static void libera(Nodo *ra) {
+		if (ra != NULL) {
+			libera(ra->_iz);
+			libera(ra->_dr);
+			delete ra;
+		}
+	}
+
+	static Nodo *copiaAux(Nodo *ra) {
+		if (ra == NULL)
+			return NULL;
+
+		Nodo *ret = new Nodo(*ra);
+		ret->_iz = copiaAux(ra->_iz);
+		ret->_dr = copiaAux(ra->_dr);
+		return ret;
+	}
+
+	static Nodo *buscaAux(Nodo *p, const Clave &clave) {
+		while ((p != NULL) && !(p->_clave == clave))
+			p = (clave < p->_clave) ? p->_iz : p->_dr;
+		return p;
+	}
+
+	/**
+	 Separa la estructura p en las claves menores que la
+	 dada (iz) y las mayores o iguales (dr). Ambas
+	 conservan la propiedad de montculo.
+	 */
+	static void divideAux(Nodo *p, const Clave &clave, Nodo *&iz, Nodo *&dr) {
+		if (p == NULL) {
+			iz = dr = NULL;
+			return;
+		}
+
+		if (p->_clave < clave) {
+			divideAux(p->_dr, clave, p->_dr, dr);
+			iz = p;
+		} else {
+			divideAux(p->_iz, clave, iz, p->_iz);
+			dr = p;
+		}
+		actualiza(p);
+	}
+
+	/**
+	 Une dos estructuras con todas las claves de iz menores
+	 que todas las de dr. La raz es la de mayor prioridad
+	 de las dos, y se sigue fusionando por el lado que
+	 queda en medio.
+	 */
+	static Nodo *fusionaAux(Nodo *iz, Nodo *dr) {
+		if (iz == NULL)
+			return dr;
+		if (dr == NULL)
+			return iz;
+
+		if (iz->_prioridad > dr->_prioridad) {
+			iz->_dr = fusionaAux(iz->_dr, dr);
+			actualiza(iz);
+			return iz;
+		} else {
+			dr->_iz = fusionaAux(iz, dr->_iz);
+			actualiza(dr);
+			return dr;
+		}
+	}
+
+	/**
+	 Inserta el nodo nuevo (cuya clave no est) en la
+	 estructura p. Se baja por el camino de bsqueda hasta
+	 el primer nodo de menor prioridad; el nuevo ocupa su
+	 lugar y ese subrbol se divide entre sus dos hijos.
+	 @return Nueva raz de la estructura.
+	 */
+	static Nodo *insertaAux(Nodo *p, Nodo *nuevo) {
+		if (p == NULL)
+			return nuevo;
+
+		if (nuevo->_prioridad > p->_prioridad) {
+			divideAux(p, nuevo->_clave, nuevo->_iz, nuevo->_dr);
+			actualiza(nuevo);
+			return nuevo;
+		}
+
+		if (nuevo->_clave < p->_clave)
+			p->_iz = insertaAux(p->_iz, nuevo);
+		else
+			p->_dr = insertaAux(p->_dr, nuevo);
+		actualiza(p);
+		return p;
+	}
+
+	/**
+	 Elimina (si existe) la clave de la estructura p; sus
+	 dos hijos se fusionan en su lugar.
+	 @return Nueva raz de la estructura.
+	 */
+	static Nodo *borraAux(Nodo *p, const Clave &clave) {
+		if (p == NULL)
+			return NULL;
+
+		if (clave == p->_clave) {
+			Nodo *ret = fusionaAux(p->_iz, p->_dr);
+			delete p;
+			return ret;
+		}
+
+		if (clave < p->_clave)
+			p->_iz = borraAux(p->_iz, clave);
+		else
+			p->_dr = borraAux(p->_dr, clave);
+		actualiza(p);
+		return p;
+	}
+
+	// //
+	// RECORRIDO PARALELO
+	// //
+
+	/**
+	 Nmero de hilos con el que empieza aplica: 1 si no
+	 se pide paralelismo; si no, los ncleos disponibles.
+	 */
+	static unsigned int hilos(bool paralelo) {
+		if (!paralelo)
+			return 1;
+		unsigned int n = std::thread::hardware_concurrency();
+		return n > 0 ? n : 2;
+	}
+
+	template <class F>
+	static void aplicaAux(Nodo *p, F &f, unsigned int hilos) {
+		if (p == NULL)
+			return;
+
+		if ((hilos > 1) && (p->_tam >= UMBRAL_PARALELO)) {
+			std::exception_ptr errorIz;
+			std::thread hiloIz([&]() {
+				try {
+					aplicaAux(p->_iz, f, hilos / 2);
+				} catch (...) {
+					errorIz = std::current_exception();
+				}
+			});
+			try {
+				f(p->_clave, p->_valor);
+				aplicaAux(p->_dr, f, hilos - hilos / 2);
+			} catch (...) {
+				hiloIz.join();
+				throw;
+			}
+			hiloIz.join();
+			if (errorIz)
+				std::rethrow_exception(errorIz);
+		} else {
+			aplicaAux(p->_iz, f, 1);
+			f(p->_clave, p->_valor);
+			aplicaAux(p->_dr, f, 1);
+		}
+	}
+
+	/**
+	 Puntero a la raz de la estructura jerrquica
+	 de nodos.
+	 */
+	Nodo *_ra;
+
+	/** Estado del generador de prioridades. */
+	unsigned int _semilla;
+};
+
+#endif // __ARBUSTREAP_H
@@ -0,0 +1,180 @@
+/**
+  @file Arena.h
+
+  Almacn de nodos reservados por bloques (arena), con
+  reutilizacin de los nodos devueltos y liberacin de
+  todos los bloques de una vez.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include "Pila.h" // Bloques reservados
+
+#include <cstddef>
+#include <new>
+
+/**
+ Arena de objetos de tipo T. En lugar de pedir memoria al
+ sistema para cada objeto, se piden bloques contiguos de
+ muchos objetos y se van repartiendo en orden, de forma que
+ los objetos reservados seguidos quedan juntos en memoria.
+ Los huecos que se devuelven se guardan en una lista de
+ libres y se reutilizan en las siguientes reservas.
+
+ La arena slo gestiona memoria: el que reserva un hueco
+ construye en l el objeto (con new de emplazamiento) y
+ es responsable de destruirlo antes de devolverlo o de
+ liberar la arena. Si T no necesita destructor, liberar la
+ arena completa cuesta O(nmero de bloques), sin recorrer
+ los objetos.
+
+ Las operaciones son:
+
+ - reserva(): hueco para un objeto.
+ - reservaContiguos(n): n huecos consecutivos, en un
+   bloque exclusivo.
+ - devuelve(p): el hueco p (ya destruido) vuelve a estar
+   disponible.
+ - liberaTodo(): devuelve al sistema todos los bloques.
+ */
+template <class T>
+class Arena {
+	static_assert(sizeof(T) >= sizeof(void*),
+				  "Los huecos libres guardan un puntero dentro del objeto");
+public:
+
+	/** Nmero de objetos del primer bloque. */
+	enum { TAM_INICIAL = 64 };
+
+	/**
+	 Nmero mximo de objetos de un bloque. Los bloques
+	 se duplican de tamao hasta llegar a ste.
+	 */
+	enum { TAM_MAXIMO = 1 << 14 };
+
+	/** Constructor; arena sin ningn bloque. */
+	Arena() {
+		inicia();
+	}
+
+	/** Destructor; libera todos los bloques. */
+	~Arena() {
+		liberaTodo();
+	}
+
+	/**
+	 Devuelve memoria sin inicializar para un objeto T,
+	 reutilizando un hueco devuelto si lo hay.
+	 */
+	T *reserva() {
+		if (_libres != NULL) {
+			Hueco *h = _libres;
+			_libres = h->_sig;
+			return reinterpret_cast<T*>(h);
+		}
+
+		if (_siguiente == _finBloque) {
+			_siguiente = nuevoBloque(_tamSiguiente);
+			_finBloque = _siguiente + _tamSiguiente;
+			if (_tamSiguiente < TAM_MAXIMO)
+				_tamSiguiente *= 2;
+		}
+		return _siguiente++;
+	}
+
+	/**
+	 Devuelve memoria sin inicializar para n objetos T
+	 consecutivos, reservada en un nico bloque nuevo.
+	 */
+	T *reservaContiguos(std::size_t n) {
+		return nuevoBloque(n);
+	}
+
+	/**
+	 Devuelve a la arena el hueco de un objeto ya
+	 destruido, para reutilizarlo ms adelante.
+	 */
+	void devuelve(T *p) {
+		Hueco *h = reinterpret_cast<Hueco*>(p);
+		h->_sig = _libres;
+		_libres = h;
+	}
+
+	/**
+	 Libera todos los bloques de la arena. No llama a
+	 ningn destructor.
+	 */
+	void liberaTodo() {
+		while (!_bloques.esVacia()) {
+			::operator delete(_bloques.cima());
+			_bloques.desapila();
+		}
+		inicia();
+	}
+
+	/** Indica si la arena no tiene ningn bloque reservado. */
+	bool esVacia() const {
+		return _bloques.esVacia();
+	}
+
+	/**
+	 Intercambia los bloques de dos arenas. Los objetos no
+	 se mueven, slo cambia qu arena es su duea.
+	 */
+	void intercambia(Arena &other) {
+		Pila<void*> bloques = _bloques;
+		_bloques = other._bloques;
+		other._bloques = bloques;
+
+		Hueco *libres = _libres; _libres = other._libres; other._libres = libres;
+		T *siguiente = _siguiente; _siguiente = other._siguiente; other._siguiente = siguiente;
+		T *fin = _finBloque; _finBloque = other._finBloque; other._finBloque = fin;
+		unsigned int tam = _tamSiguiente; _tamSiguiente = other._tamSiguiente; other._tamSiguiente = tam;
+	}
+
+private:
+
+	// La arena no se puede copiar
+	Arena(const Arena &);
+	Arena &operator=(const Arena &);
+
+	/**
+	 Un hueco libre guarda dentro el puntero al siguiente
+	 hueco libre.
+	 */
+	struct Hueco {
+		Hueco *_sig;
+	};
+
+	void inicia() {
+		_libres = NULL;
+		_siguiente = NULL;
+		_finBloque = NULL;
+		_tamSiguiente = TAM_INICIAL;
+	}
+
+	T *nuevoBloque(std::size_t n) {
+		void *bloque = ::operator new(n * sizeof(T));
+		_bloques.apila(bloque);
+		return static_cast<T*>(bloque);
+	}
+
+	/** Bloques pedidos al sistema. */
+	Pila<void*> _bloques;
+
+	/** Lista de huecos devueltos. */
+	Hueco *_libres;
+
+	/** Siguiente hueco sin usar del bloque actual y fin de ste. */
+	T *_siguiente;
+	T *_finBloque;
+
+	/** Nmero de objetos del prximo bloque. */
+	unsigned int _tamSiguiente;
+};
+
+#endif // __ARENA_H
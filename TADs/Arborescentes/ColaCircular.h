@@ -0,0 +1,212 @@
+/**
+  @file ColaCircular.h
+
+  Implementacin del TAD Cola utilizando un vector
+  dinmico circular cuyo tamao va creciendo si es
+  necesario.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __COLACIRCULAR_H
+#define __COLACIRCULAR_H
+
+#include "Excepciones.h"
+
+/**
+ Implementacin del TAD Cola utilizando un vector circular:
+ los elementos ocupan las posiciones _ini, _ini + 1, ...
+ (mdulo _tam). A diferencia de Cola, no hay una peticin de
+ memoria por elemento; slo se pide memoria cuando el vector
+ se llena (y se duplica su tamao).
+
+ Las operaciones son:
+
+ - ColaVacia: -> Cola. Generadora implementada en el
+   constructor sin parmetros.
+ - PonDetras: Cola, Elem -> Cola. Generadora
+ - quitaPrim: Cola - -> Cola. Modificadora parcial.
+ - primero: Cola - -> Elem. Observadora parcial.
+ - esVacia: Cola -> Bool. Observadora.
+ - numElems: Cola -> Entero. Observadora.
+ */
+template <class T>
+class ColaCircular {
+public:
+
+	/** Tamao inicial del vector dinmico. */
+	enum { TAM_INICIAL = 16 };
+
+	/** Constructor; operacin ColaVacia */
+	ColaCircular() {
+		inicia();
+	}
+
+	/** Destructor; elimina el vector. */
+	~ColaCircular() {
+		libera();
+	}
+
+	/**
+	 Aade un elemento en la parte trasera de la cola.
+	 Operacin generadora.
+
+	 @param elem Elemento a aadir.
+	*/
+	void ponDetras(const T &elem) {
+		if (_numElems == _tam)
+			amplia();
+		_v[(_ini + _numElems) % _tam] = elem;
+		_numElems++;
+	}
+
+	/**
+	 Elimina el primer elemento de la cola.
+	 Operacin modificadora parcial, que falla si
+	 la cola est vaca.
+
+	 quitaPrim(PonDetras(elem, ColaVacia)) = ColaVacia
+	 quitaPrim(PonDetras(elem, xs)) = PonDetras(elem, quitaPrim(xs)) si !esVacia(xs)
+	 error: quitaPrim(ColaVacia)
+	*/
+	void quitaPrim() {
+		if (esVacia())
+			throw EColaVacia();
+		_ini = (_ini + 1) % _tam;
+		--_numElems;
+	}
+
+	/**
+	 Devuelve el primer elemento de la cola. Operacin
+	 observadora parcial, que falla si la cola est vaca.
+
+	 primero(PonDetras(elem, ColaVacia)) = elem
+	 primero(PonDetras(elem, xs)) = primero(xs) si !esVacia(xs)
+	 error: primero(ColaVacia)
+
+	 @return El primer elemento de la cola.
+	 */
+	const T &primero() const {
+		if (esVacia())
+			throw EColaVacia();
+		return _v[_ini];
+	}
+
+	/**
+	 Devuelve true si la cola no tiene ningn elemento.
+
+	 esVacia(Cola) = true
+	 esVacia(PonDetras(elem, p)) = false
+
+	 @return true si la cola no tiene ningn elemento.
+	 */
+	bool esVacia() const {
+		return _numElems == 0;
+	}
+
+	/**
+	 Devuelve el nmero de elementos que hay en la
+	 cola.
+	 numElems(ColaVacia) = 0
+	 numElems(PonDetras(elem, p)) = 1 + numElems(p)
+
+	 @return Nmero de elementos.
+	 */
+	int numElems() const {
+		return _numElems;
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ColaCircular(const ColaCircular<T> &other) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ColaCircular<T> &operator=(const ColaCircular<T> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+	/** Operador de comparacin. */
+	bool operator==(const ColaCircular<T> &rhs) const {
+		if (_numElems != rhs._numElems)
+			return false;
+		for (unsigned int i = 0; i < _numElems; ++i)
+			if (_v[(_ini + i) % _tam] != rhs._v[(rhs._ini + i) % rhs._tam])
+				return false;
+		return true;
+	}
+
+	bool operator!=(const ColaCircular<T> &rhs) const {
+		return !(*this == rhs);
+	}
+
+protected:
+
+	void inicia() {
+		_v = new T[TAM_INICIAL];
+		_tam = TAM_INICIAL;
+		_ini = 0;
+		_numElems = 0;
+	}
+
+	void libera() {
+		delete []_v;
+		_v = NULL;
+	}
+
+	/**
+	 Copia los elementos de other; en la copia, el
+	 primero queda en la posicin 0.
+	 */
+	void copia(const ColaCircular &other) {
+		_tam = other._numElems + TAM_INICIAL;
+		_numElems = other._numElems;
+		_ini = 0;
+		_v = new T[_tam];
+		for (unsigned int i = 0; i < _numElems; ++i)
+			_v[i] = other._v[(other._ini + i) % other._tam];
+	}
+
+	/**
+	 Duplica el tamao del vector, "desenrollando" los
+	 elementos para que el primero quede en la posicin 0.
+	 */
+	void amplia() {
+		T *viejo = _v;
+		unsigned int tamViejo = _tam;
+		_tam *= 2;
+		_v = new T[_tam];
+
+		for (unsigned int i = 0; i < _numElems; ++i)
+			_v[i] = viejo[(_ini + i) % tamViejo];
+		_ini = 0;
+
+		delete []viejo;
+	}
+
+private:
+
+	/** Puntero al array que contiene los datos. */
+	T *_v;
+
+	/** Tamao del vector _v. */
+	unsigned int _tam;
+
+	/** Posicin del primer elemento de la cola. */
+	unsigned int _ini;
+
+	/** Nmero de elementos reales guardados. */
+	unsigned int _numElems;
+};
+
+#endif // __COLACIRCULAR_H
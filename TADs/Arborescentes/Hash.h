@@ -0,0 +1,59 @@
+/**
+ @file Hash.h
+ 
+ Declaracin e implementacin de funciones de localizacin para
+ tipos bsicos y funcin genrica que confa en la existencia
+ del mtodo mtodo hash de las clases.
+ 
+ Estructura de Datos y Algoritmos
+ Facultad de Informtica
+ Universidad Complutense de Madrid
+ 
+ (c) Antonio Snchez Ruiz-Granados, 2012
+ */
+#ifndef __HASH_H
+#define __HASH_H
+
+#include <string>
+
+
+// ----------------------------------------------------
+//
+// Funciones hash para distintos tipos de datos bsicos
+//
+// ----------------------------------------------------
+
+inline unsigned int hash(unsigned int clave) {
+	return clave;
+}
+
+inline unsigned int hash(int clave) {
+	return (unsigned int) clave;
+}
+
+inline unsigned int hash(char clave) {
+	return clave;
+}
+
+// Nota: Esta funcin de hash para cadenas no es muy buena.
+inline unsigned int hash(std::string clave) {
+	
+	// Suma los valores ASCII de todos sus caracters.
+	unsigned int valor = 0;
+	for (unsigned int i=0; i<clave.length(); ++i) {
+		valor += clave[i];
+	}
+	return valor;
+}
+
+
+/**
+ * Funcin hash genrica para clases que implementen un
+ * mtodo publico hash.
+ */
+template<class C>
+unsigned int hash(const C &clave) {
+	return clave.hash();
+}
+
+#endif // __HASH_H
@@ -0,0 +1,209 @@
+/**
+  @file PoolIndices.h
+
+  Almacn de nodos en un vector, direccionados por ndices
+  de 32 bits en lugar de por punteros.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __POOLINDICES_H
+#define __POOLINDICES_H
+
+#include "Excepciones.h"
+
+#include "Pila.h" // Huecos libres
+
+#include <cassert>
+
+/**
+ Almacn de objetos de tipo T guardados en un vector que
+ crece por duplicacin (como el de Pila). Cada objeto se
+ identifica por su posicin en el vector (un Indice de 32
+ bits), de modo que una estructura enlazada puede guardar
+ en sus nodos ndices de 4 bytes en lugar de punteros de 8.
+ La posicin 0 no se usa nunca: el ndice NULO hace el
+ papel del puntero NULL.
+
+ Los huecos que se devuelven se apilan y se reutilizan en
+ las siguientes reservas. Copiar el almacn copia el vector
+ tal cual, as que la copia de una estructura enlazada
+ guardada en l conserva los mismos ndices y no hace falta
+ recorrerla.
+
+ Como el vector puede cambiar de sitio al crecer, las
+ referencias a sus objetos (las devueltas por el operador
+ []) dejan de ser vlidas tras cualquier reserva.
+
+ El vector crece hasta 2^31 posiciones (duplicarlo otra vez
+ desbordara los ndices), as que caben como mucho
+ MAX_ELEMS = 2^31 - 1 objetos a la vez.
+
+ T debe tener constructor sin parmetros.
+ */
+template <class T>
+class PoolIndices {
+public:
+
+	/** Tipo de los ndices. */
+	typedef unsigned int Indice;
+
+	/** ndice que no corresponde a ningn objeto. */
+	enum { NULO = 0 };
+
+	/** Tamao inicial del vector. */
+	enum { TAM_INICIAL = 16 };
+
+	/** Nmero mximo de objetos guardados a la vez. */
+	static const Indice MAX_ELEMS = 0x7FFFFFFFu;
+
+	/** Constructor; almacn vaco. */
+	PoolIndices() {
+		inicia();
+	}
+
+	/** Destructor; elimina el vector. */
+	~PoolIndices() {
+		libera();
+	}
+
+	/**
+	 Guarda una copia de un objeto en un hueco libre.
+	 El objeto puede estar en el propio almacn. Si no
+	 queda sitio (hay MAX_ELEMS objetos) se lanza
+	 EAccesoInvalido; si falla la reserva del vector o la
+	 copia de algn objeto, el almacn queda como estaba.
+	 @param valor Objeto a guardar.
+	 @return ndice del hueco en el que queda.
+	 */
+	Indice reserva(const T &valor) {
+		Indice ret;
+		if (!_libres.esVacia()) {
+			ret = _libres.cima();
+			_libres.desapila();
+			_v[ret] = valor;
+			return ret;
+		}
+
+		ret = _numUsados;
+		if (_numUsados == _tam) {
+			// Con 2^31 posiciones no se puede duplicar ms
+			if (_tam > MAX_ELEMS)
+				throw EAccesoInvalido("PoolIndices lleno");
+
+			// valor puede estar en el vector viejo, as que
+			// se copia antes de liberarlo; _v y _tam slo
+			// cambian cuando el vector nuevo est completo
+			Indice tam = _tam * 2;
+			T *nuevo = new T[tam];
+			try {
+				for (Indice i = 1; i < _numUsados; ++i)
+					nuevo[i] = _v[i];
+				nuevo[ret] = valor;
+			} catch (...) {
+				delete []nuevo;
+				throw;
+			}
+			delete []_v;
+			_v = nuevo;
+			_tam = tam;
+		} else
+			_v[ret] = valor;
+		_numUsados++;
+		return ret;
+	}
+
+	/**
+	 Devuelve un hueco al almacn. Su objeto se sustituye
+	 por uno construido sin parmetros, para liberar los
+	 recursos que tuviera.
+	 @param i ndice del hueco (distinto de NULO).
+	 */
+	void devuelve(Indice i) {
+		assert((i != NULO) && (i < _numUsados));
+		_v[i] = T();
+		_libres.apila(i);
+	}
+
+	/** Acceso al objeto de un ndice (distinto de NULO). */
+	T &operator[](Indice i) {
+		return _v[i];
+	}
+
+	const T &operator[](Indice i) const {
+		return _v[i];
+	}
+
+	/** Nmero de objetos guardados. */
+	unsigned int numElems() const {
+		return _numUsados - 1 - _libres.numElems();
+	}
+
+	/** Vaca el almacn y libera su memoria. */
+	void liberaTodo() {
+		libera();
+		inicia();
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	PoolIndices(const PoolIndices<T> &other) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	PoolIndices<T> &operator=(const PoolIndices<T> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+protected:
+
+	void inicia() {
+		_v = new T[TAM_INICIAL];
+		_tam = TAM_INICIAL;
+		_numUsados = 1;
+		_libres = Pila<Indice>();
+	}
+
+	void libera() {
+		delete []_v;
+		_v = NULL;
+	}
+
+	void copia(const PoolIndices &other) {
+		_tam = other._numUsados + TAM_INICIAL;
+		_numUsados = other._numUsados;
+		_v = new T[_tam];
+		for (Indice i = 1; i < _numUsados; ++i)
+			_v[i] = other._v[i];
+		_libres = other._libres;
+	}
+
+private:
+
+	/** Puntero al vector de objetos. */
+	T *_v;
+
+	/** Tamao del vector _v. */
+	Indice _tam;
+
+	/**
+	 Nmero de posiciones usadas del vector (incluida la
+	 0); las siguientes no se han reservado nunca.
+	 */
+	Indice _numUsados;
+
+	/** Huecos devueltos, para reutilizarlos. */
+	Pila<Indice> _libres;
+};
+
+#endif // __POOLINDICES_H